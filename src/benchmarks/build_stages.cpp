@@ -0,0 +1,191 @@
+/*
+    This file is part of graphics-lib.
+
+    Copyright (c) 2020, 2021, 2022 Bernardo Fichera <bernardo.fichera@gmail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+
+#include <graphics_lib/Graphics.hpp>
+
+#include <Corrade/Containers/StringStl.h>
+#include <Magnum/DebugTools/ColorMap.h>
+#include <Magnum/MeshTools/CompressIndices.h>
+
+using namespace graphics_lib;
+
+// CPU preparation stages timed in isolation (no GL context needed)
+// Usage: build_stages [output.json] [resources directory]
+// Results are printed as JSON (median and minimum time per run) to be compared across commits
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    // Each case runs at least MinRepetitions times and until MinTime has elapsed (at most MaxRepetitions times)
+    constexpr size_t MinRepetitions = 5, MaxRepetitions = 1000;
+    constexpr std::chrono::milliseconds MinTime{200};
+
+    struct Result {
+        std::string name;
+        size_t size;
+        size_t repetitions;
+        double median, min; // nanoseconds
+    };
+
+    // Written after every run so that the measured work cannot be optimized away
+    volatile double sink = 0;
+
+    template <typename Function>
+    Result measure(const std::string& name, const size_t& size, Function&& run)
+    {
+        std::vector<double> samples;
+        const Clock::time_point start = Clock::now();
+
+        while (samples.size() < MinRepetitions || (Clock::now() - start < MinTime && samples.size() < MaxRepetitions)) {
+            const Clock::time_point begin = Clock::now();
+            sink = run();
+            samples.push_back(std::chrono::duration<double, std::nano>(Clock::now() - begin).count());
+        }
+
+        std::sort(samples.begin(), samples.end());
+
+        Result result{name, size, samples.size(), samples[samples.size() / 2], samples.front()};
+        std::cerr << name << " [" << size << "]: " << result.median * 1e-6 << " ms (" << result.repetitions << " runs)" << std::endl;
+
+        return result;
+    }
+
+    void write(std::ostream& out, const std::vector<Result>& results)
+    {
+        out << "{\n  \"unit\": \"ns\",\n  \"benchmarks\": [\n";
+        for (size_t i = 0; i < results.size(); i++)
+            out << "    {\"name\": \"" << results[i].name << "\", \"size\": " << results[i].size << ", \"repetitions\": " << results[i].repetitions
+                << ", \"median\": " << size_t(results[i].median) << ", \"min\": " << size_t(results[i].min) << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+        out << "  ]\n}" << std::endl;
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const std::string output = (argc > 1) ? argv[1] : "", resources = (argc > 2) ? argv[2] : "rsc";
+    const std::vector<size_t> sizes = {1000, 10000, 100000, 1000000};
+
+    std::vector<Result> results;
+
+    for (const size_t& n : sizes) {
+        // Vertex arrays (double input converted to row-major float, as done by surface/trajectory)
+        const Eigen::MatrixXd vertices = Eigen::MatrixXd::Random(n, 3);
+        Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor> points;
+
+        results.push_back(measure("vertices/convert", n, [&]() {
+            points = vertices.cast<float>();
+            return points(n - 1, 2);
+        }));
+
+        // Colormapping (linear float colors and packed 8-bit colors)
+        const Eigen::VectorXd values = Eigen::VectorXd::Random(n);
+        const tools::Colormap colormap{DebugTools::ColorMap::turbo()};
+
+        Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor> colors;
+        results.push_back(measure("colormap/linear", n, [&]() {
+            colormap.map(values, -1.0, 1.0, colors);
+            return colors(n - 1, 0);
+        }));
+
+        Containers::Array<Color4ub> packed{Containers::NoInit, n};
+        results.push_back(measure("colormap/packed", n, [&]() {
+            colormap.map(values, -1.0, 1.0, packed);
+            return packed[n - 1].r();
+        }));
+
+        // Index compression (one triangle per vertex)
+        Containers::Array<UnsignedInt> indices{Containers::NoInit, 3 * n};
+        for (size_t i = 0; i < indices.size(); i++)
+            indices[i] = UnsignedInt(std::rand() % n);
+
+        results.push_back(measure("indices/compress", n, [&]() {
+            std::pair<Containers::Array<char>, MeshIndexType> compressed = MeshTools::compressIndices(indices);
+            return compressed.first.size();
+        }));
+
+        // Object hierarchy (8 children per object, created and destroyed with the scene)
+        if (n <= 100000) {
+            results.push_back(measure("hierarchy/create", n, [&]() {
+                std::unordered_map<objects::ObjectHandle3D*, Containers::Pointer<drawables::AbstractDrawable3D>> drawables;
+                SceneGraph::Scene<SceneGraph::MatrixTransformation3D> scene;
+
+                std::vector<objects::ObjectHandle3D*> handles;
+                handles.reserve(n);
+                handles.push_back(new objects::ObjectHandle3D(&scene, drawables));
+
+                for (size_t i = 1; i < n; i++)
+                    handles.push_back(new objects::ObjectHandle3D(handles[(i - 1) / 8], drawables));
+
+                return handles.size();
+            }));
+        }
+    }
+
+    // Importer parsing of every file in the resources directory
+    PluginManager::Manager<Trade::AbstractImporter> manager;
+    Containers::Pointer<Trade::AbstractImporter> importer = manager.loadAndInstantiate("AnySceneImporter");
+
+    Containers::Optional<Containers::Array<Containers::String>> files = Utility::Path::list(resources, Utility::Path::ListFlag::SkipDirectories | Utility::Path::ListFlag::SkipDotAndDotDot | Utility::Path::ListFlag::SortAscending);
+
+    if (importer && files) {
+        for (const Containers::String& name : *files) {
+            const std::string file = Utility::Path::join(resources, name);
+
+            if (!importer->openFile(file)) {
+                Warning{} << "Skipping" << file.c_str();
+                continue;
+            }
+            importer->close();
+
+            const Containers::Optional<std::size_t> bytes = Utility::Path::size(file);
+
+            results.push_back(measure("import/" + std::string{name}, bytes ? *bytes : 0, [&]() {
+                size_t vertices = 0;
+
+                if (importer->openFile(file)) {
+                    for (UnsignedInt i = 0; i < importer->meshCount(); i++)
+                        if (Containers::Optional<Trade::MeshData> mesh = importer->mesh(i))
+                            vertices += mesh->vertexCount();
+                    importer->close();
+                }
+
+                return vertices;
+            }));
+        }
+    }
+
+    if (output.empty())
+        write(std::cout, results);
+    else {
+        std::ofstream file(output);
+        write(file, results);
+    }
+
+    return 0;
+}
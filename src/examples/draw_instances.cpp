@@ -0,0 +1,53 @@
+/*
+    This file is part of graphics-lib.
+
+    Copyright (c) 2020, 2021, 2022 Bernardo Fichera <bernardo.fichera@gmail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <Eigen/Geometry>
+#include <graphics_lib/Graphics.hpp>
+
+using namespace graphics_lib;
+
+int main(int argc, char** argv)
+{
+    Graphics app({argc, argv});
+
+    // Random particle cloud (single draw call)
+    size_t num_particles = 10000;
+    Eigen::Matrix<double, Eigen::Dynamic, 3> positions = 3 * Eigen::Matrix<double, Eigen::Dynamic, 3>::Random(num_particles, 3),
+                                             colors = 0.5 * (Eigen::Matrix<double, Eigen::Dynamic, 3>::Random(num_particles, 3).array() + 1);
+
+    app.primitives("sphere", positions, colors, 0.02);
+
+    // Randomly oriented small boxes (4x4 row-major transformations)
+    size_t num_boxes = 100;
+    Eigen::Matrix<double, Eigen::Dynamic, 16, Eigen::RowMajor> poses(num_boxes, 16);
+    for (size_t i = 0; i < num_boxes; i++) {
+        const Eigen::Affine3d pose = Eigen::Translation3d(3 * Eigen::Vector3d::Random()) * Eigen::Quaterniond::UnitRandom() * Eigen::Scaling(0.05);
+        const Eigen::Matrix<double, 4, 4, Eigen::RowMajor> matrix = pose.matrix();
+        poses.row(i) = Eigen::Map<const Eigen::Matrix<double, 1, 16>>(matrix.data());
+    }
+
+    app.primitivesFromPoses("cube", poses);
+
+    return app.exec();
+}
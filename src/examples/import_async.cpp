@@ -0,0 +1,44 @@
+/*
+    This file is part of graphics-lib.
+
+    Copyright (c) 2020, 2021, 2022 Bernardo Fichera <bernardo.fichera@gmail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <graphics_lib/Graphics.hpp>
+
+using namespace graphics_lib;
+
+int main(int argc, char** argv)
+{
+    Graphics app({argc, argv});
+
+    std::string fname = (argc > 1) ? argv[1] : "rsc/link5.dae";
+
+    // Window keeps drawing while the file is parsed and uploaded
+    app.importAsync(
+        fname, "",
+        [](objects::ObjectHandle3D&, const float& progress) { std::cout << "Upload: " << 100 * progress << "%" << std::endl; },
+        [](objects::ObjectHandle3D& object) { object.setTransformation(Matrix4::scaling(Vector3{4.0, 4.0, 4.0})); });
+
+    app.frame();
+
+    return app.exec();
+}
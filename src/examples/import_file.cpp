@@ -34,7 +34,8 @@ int main(int argc, char** argv)
 
     std::string fname = (argc > 1) ? argv[1] : "rsc/drone.stl";
 
-    app.import(fname);
+    // Parsed once, then reloaded from the binary cache
+    app.setCacheDirectory("cache").import(fname);
     app.frame().setTransformation(Matrix4::scaling(Vector3{4.0,4.0,4.0}));
 
     return app.exec();
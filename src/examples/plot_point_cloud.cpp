@@ -0,0 +1,41 @@
+/*
+    This file is part of graphics-lib.
+
+    Copyright (c) 2020, 2021, 2022 Bernardo Fichera <bernardo.fichera@gmail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <graphics_lib/Graphics.hpp>
+
+using namespace graphics_lib;
+
+int main(int argc, char** argv)
+{
+    Graphics app({argc, argv});
+
+    // Random points on a wavy sheet (colored by elevation)
+    size_t num_points = 5000000;
+    Eigen::Matrix<double, Eigen::Dynamic, 3> points = 5 * Eigen::Matrix<double, Eigen::Dynamic, 3>::Random(num_points, 3);
+    points.col(2) = (points.col(0).array().sin() * points.col(1).array().cos()).matrix();
+
+    app.pointCloud(points).setPointBudget(2000000);
+
+    return app.exec();
+}
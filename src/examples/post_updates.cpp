@@ -0,0 +1,69 @@
+/*
+    This file is part of graphics-lib.
+
+    Copyright (c) 2020, 2021, 2022 Bernardo Fichera <bernardo.fichera@gmail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <chrono>
+#include <thread>
+
+#include <graphics_lib/Graphics.hpp>
+
+using namespace graphics_lib;
+
+int main(int argc, char** argv)
+{
+    Graphics app({argc, argv});
+
+    auto& sphere = app.primitive("sphere")
+                       .addPriorTransformation(Matrix4::scaling({0.2f, 0.2f, 0.2f}))
+                       .setColor(Color4::red());
+
+    app.camera3D().setPose(Vector3{5., 0., 5.});
+
+    // Simulation loop running on its own thread (never touches the scene directly)
+    std::atomic<bool> running{true};
+    std::thread simulation([&]() {
+        float time = 0;
+
+        while (running) {
+            time += 0.001f;
+            app.post(sphere, Matrix4::translation({Math::cos(Rad{time}), Math::sin(Rad{time}), 0.0f}));
+
+            // Objects are created on the rendering thread
+            if (int(time * 1000) % 1000 == 0)
+                app.post([time](Graphics& graphics) {
+                    graphics.primitive("cube")
+                        .addPriorTransformation(Matrix4::scaling({0.05f, 0.05f, 0.05f}))
+                        .setTransformation(Matrix4::translation({Math::cos(Rad{time}), Math::sin(Rad{time}), 0.0f}));
+                });
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+
+    int result = app.exec();
+
+    running = false;
+    simulation.join();
+
+    return result;
+}
@@ -0,0 +1,51 @@
+/*
+    This file is part of graphics-lib.
+
+    Copyright (c) 2020, 2021, 2022 Bernardo Fichera <bernardo.fichera@gmail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <graphics_lib/Graphics.hpp>
+
+using namespace graphics_lib;
+
+int main(int argc, char** argv)
+{
+    // Build with "waf configure --headless" to run without display (e.g. EGL_PLATFORM=surfaceless with Mesa)
+    Graphics app({argc, argv});
+
+    std::string fname = (argc > 1) ? argv[1] : "rsc/drone.stl";
+    size_t frames = (argc > 2) ? std::stoul(argv[2]) : 36;
+
+    app.setSize({1024, 768}).setBackground("white");
+    app.import(fname);
+    app.frame().setTransformation(Matrix4::scaling(Vector3{4.0, 4.0, 4.0}));
+
+    // Orbit around the object and save one image per camera pose
+    for (size_t i = 0; i < frames; ++i) {
+        const Rad angle{2.0f * Constants::pi() * i / frames};
+        app.camera3D().setPose(Vector3{10.0f * Math::cos(angle), 10.0f * Math::sin(angle), 3.0f});
+
+        if (!app.snapshot("snapshot_" + std::to_string(i) + ".png"))
+            return 1;
+    }
+
+    return 0;
+}
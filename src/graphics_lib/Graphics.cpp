@@ -37,10 +37,13 @@
 /* MATH */
 #include "graphics_lib/tools/math.hpp"
 
-/* COLORMAPS */
+/* COLORMAPS & SNAPSHOTS */
 #include <Magnum/DebugTools/ColorMap.h>
+#include <Magnum/DebugTools/Screenshot.h>
 
 /* SHADERS */
+#include "graphics_lib/shaders/ScalarColorGL.hpp"
+#include <Magnum/Shaders/FlatGL.h>
 #include <Magnum/Shaders/Phong.h>
 #include <Magnum/Shaders/VertexColorGL.h>
 
@@ -49,11 +52,16 @@
 
 /* CORRADE TOOLS */
 #include <Corrade/Containers/Pair.h>
+#include <Corrade/Containers/StringStl.h>
+#include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/DebugStl.h>
 
 /* GL TOOLS */
 #include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Extensions.h>
 #include <Magnum/GL/Renderer.h>
+#include <Magnum/GL/Texture.h>
 #include <Magnum/GL/TextureFormat.h>
 
 /* MESH TOOLS*/
@@ -64,6 +72,7 @@
 /* MAGNUM MAIN */
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Sampler.h>
 
 /* TRADE TOOLS */
 #include <Magnum/Trade/ImageData.h>
@@ -73,8 +82,14 @@
 
 namespace graphics_lib {
     Graphics::Graphics(const Arguments& arguments)
-        : Platform::Application{arguments, NoCreate}
+        : GraphicsApplication{arguments, NoCreate}
     {
+#ifdef GRAPHICSLIB_HEADLESS
+        /* Offscreen context (no display needed) rendering to a framebuffer */
+        if (!tryCreateContext({}))
+            Fatal{} << "Cannot create windowless context";
+        setSize({800, 600});
+#else
         /* Try 8x MSAA, fall back to zero samples if not possible. Enable only 2x MSAA if we have enough DPI. */
         {
             const Vector2 dpiScaling = this->dpiScaling({});
@@ -87,13 +102,17 @@ namespace graphics_lib {
             if (!tryCreate(conf, glConf))
                 create(conf, glConf.setSampleCount(0));
         }
+#endif
 
         /* Create cameras */
         _cameraTemp2D.reset(new cameras::CameraHandle2D(_scene2D));
         _cameraTemp3D.reset(new cameras::CameraHandle3D(_scene3D));
+        _cameraTemp2D->setRedrawFlag(&_changed);
+        _cameraTemp3D->setRedrawFlag(&_changed);
 
-        /* Basic object parent of all the others */
+        /* Basic object parent of all the others (children share its redraw flag) */
         _manipulator = new objects::ObjectHandle3D(&_scene3D, _drawables3D);
+        _manipulator->setRedrawFlag(&_changed);
 
         /* Recall something from OpenGL study but don't precisely */
         GL::Renderer::enable(GL::Renderer::Feature::DepthTest);
@@ -118,22 +137,61 @@ namespace graphics_lib {
             .setSpecularColor(0x111111_rgbf)
             .setShininess(80.0f);
 
+        // Instanced shader (per-instance transformation and color)
+        _shadersManager.set<GL::AbstractShaderProgram>("instanced",
+            new Shaders::PhongGL(Shaders::PhongGL::Configuration{}.setFlags(Shaders::PhongGL::Flag::InstancedTransformation | Shaders::PhongGL::Flag::VertexColor).setLightCount(2)));
+        _shadersManager.get<GL::AbstractShaderProgram, Shaders::PhongGL>("instanced")
+            ->setAmbientColor(0x111111_rgbf)
+            .setSpecularColor(0xffffff_rgbf)
+            .setShininess(80.0f);
+
+        // Instanced shader with a single color (override color of the instanced drawables)
+        _shadersManager.set<GL::AbstractShaderProgram>("instancedUniform",
+            new Shaders::PhongGL(Shaders::PhongGL::Configuration{}.setFlags(Shaders::PhongGL::Flag::InstancedTransformation).setLightCount(2)));
+        _shadersManager.get<GL::AbstractShaderProgram, Shaders::PhongGL>("instancedUniform")
+            ->setAmbientColor(0x111111_rgbf)
+            .setSpecularColor(0xffffff_rgbf)
+            .setShininess(80.0f);
+
+        // Uniform buffer versions of the phong/texture shaders (render queue), same default material
+        if (GL::Context::current().isExtensionSupported<GL::Extensions::ARB::uniform_buffer_object>()) {
+            _phongQueue = Containers::pointer<drawables::UniformQueue>(Shaders::PhongGL::Flags{}, 2,
+                Shaders::PhongMaterialUniform{}.setAmbientColor(0x111111_rgbf).setSpecularColor(0xffffff_rgbf).setShininess(80.0f));
+            _textureQueue = Containers::pointer<drawables::UniformQueue>(Shaders::PhongGL::Flag::DiffuseTexture, 2,
+                Shaders::PhongMaterialUniform{}.setAmbientColor(0x111111_rgbf).setSpecularColor(0x111111_rgbf).setShininess(80.0f));
+        }
+
         // Color shader (2D/3D)
         _shadersManager.set<GL::AbstractShaderProgram>("color3D", new Shaders::VertexColorGL3D);
         _shadersManager.set<GL::AbstractShaderProgram>("color2D", new Shaders::VertexColorGL2D);
 
+        // Flat shader (uniform color)
+        _shadersManager.set<GL::AbstractShaderProgram>("flat3D", new Shaders::FlatGL3D);
+
+        // Scalar shader (2D/3D)
+        _shadersManager.set<GL::AbstractShaderProgram>("scalar3D", new shaders::ScalarColorGL3D);
+        _shadersManager.set<GL::AbstractShaderProgram>("scalar2D", new shaders::ScalarColorGL2D);
+
         // Default importer
         _importer = _manager.loadAndInstantiate("AnySceneImporter");
 
+#ifdef GRAPHICSLIB_HEADLESS
+        /* Cameras were created with the (empty) default framebuffer viewport */
+        _cameraTemp2D->setViewport(_framebuffer.viewport().size());
+        _cameraTemp3D->setViewport(_framebuffer.viewport().size());
+#else
         /* Loop at 60 Hz max */
         setSwapInterval(1);
         setMinimalLoopPeriod(16);
 
         redraw();
+#endif
     }
 
     Graphics::~Graphics()
     {
+        _recorder = nullptr;
+        _imports.clear();
         _drawables3D.clear();
         _drawables2D.clear();
     }
@@ -144,11 +202,62 @@ namespace graphics_lib {
         return *this;
     }
 
+    Graphics& Graphics::setSize(const Vector2i& size)
+    {
+#ifdef GRAPHICSLIB_HEADLESS
+        // Re-create the offscreen render target
+        (_colorbuffer = GL::Renderbuffer{}).setStorage(GL::RenderbufferFormat::RGBA8, size);
+        (_depthbuffer = GL::Renderbuffer{}).setStorage(GL::RenderbufferFormat::Depth24Stencil8, size);
+        (_framebuffer = GL::Framebuffer{{{}, size}})
+            .attachRenderbuffer(GL::Framebuffer::ColorAttachment{0}, _colorbuffer)
+            .attachRenderbuffer(GL::Framebuffer::BufferAttachment::DepthStencil, _depthbuffer);
+
+        if (_cameraTemp3D) {
+            _cameraTemp2D->setViewport(size);
+            _cameraTemp3D->setViewport(size);
+        }
+#else
+        // Viewport (and cameras) updated by the viewport event
+        setWindowSize(size);
+#endif
+        return *this;
+    }
+
+    Graphics& Graphics::setContinuous(const bool& continuous)
+    {
+        _continuous = continuous;
+#ifndef GRAPHICSLIB_HEADLESS
+        redraw();
+#endif
+        return *this;
+    }
+
+    Graphics& Graphics::setRenderQueue(const bool& enable)
+    {
+        _renderQueue = enable;
+        return *this;
+    }
+
+    Graphics& Graphics::setDetailLevels(const size_t& levels)
+    {
+        _detailLevels = levels;
+        return *this;
+    }
+
+    Graphics& Graphics::setQuantization(const bool& enable)
+    {
+        _quantization = enable;
+        return *this;
+    }
+
     objects::ObjectHandle3D& Graphics::frame()
     {
-        auto axis_mesh = Primitives::axis3D();
+        tools::Profiler::Section profile = _profiler.section("axes");
 
-        GL::Mesh mesh = MeshTools::compile(axis_mesh);
+        // Axis mesh (compiled once and shared by all the frames)
+        Resource<GL::Mesh> mesh = _resourcesManager.get<GL::Mesh>("axis");
+        if (!mesh)
+            _resourcesManager.set<GL::Mesh>("axis", new GL::Mesh{MeshTools::compile(Primitives::axis3D())});
 
         // Create object
         auto it = _drawables3D.insert(std::make_pair(new objects::ObjectHandle3D(_manipulator, _drawables3D), nullptr));
@@ -158,51 +267,29 @@ namespace graphics_lib {
             // Create drawable
             it.first->second = Containers::pointer<drawables::ColorDrawable3D>(*it.first->first, _color3D, *_shadersManager.get<GL::AbstractShaderProgram, Shaders::VertexColorGL3D>("color3D"));
 
-            // Set drawable mesh
-            it.first->second->setMesh(mesh);
+            // Set drawable mesh (arrows span [0, 1] along each axis)
+            it.first->second->setMesh(mesh).setBoundingBox(Range3D{Vector3{-0.1f}, Vector3{1.1f}});
         }
 
         return *it.first->first;
     }
 
     // Add trajectory (only 3D for the moment)
-    objects::ObjectHandle3D& Graphics::trajectory(const Eigen::Matrix<double, Eigen::Dynamic, 3>& trajectory, const std::string& color_to_set)
+    objects::ObjectHandle3D& Graphics::trajectory(const Eigen::Ref<const Eigen::Matrix<double, Eigen::Dynamic, 3>>& trajectory, const std::string& color_to_set)
     {
-        // handle object
-        auto handle_obj = new objects::ObjectHandle3D(_manipulator, _drawables3D);
-
-        // vertices & indices
-        struct VertexData {
-            Vector3 position;
-            Color3 color;
-        };
-        Containers::Array<VertexData> vertices{size_t(trajectory.rows())};
-        Containers::Array<UnsignedShort> indices;
+        tools::Profiler::Section profile = _profiler.section("trajectory (double)");
 
-        for (size_t i = 0; i < trajectory.rows() - 1; i++) {
-            Eigen::Vector3f vertex = trajectory.row(i).cast<float>();
-            Color3 color = tools::color<Color3>(color_to_set);
-            vertices[i] = VertexData{Vector3(vertex), color};
-            arrayAppend(indices, i);
-            arrayAppend(indices, i + 1);
-        }
-        Eigen::Vector3f vertex = trajectory.row(trajectory.rows() - 1).cast<float>();
-        vertices[trajectory.rows() - 1] = VertexData{Vector3(vertex), Color3::green()};
-
-        // Vertex buffer
-        GL::Buffer vertex_buffer;
-        vertex_buffer.setData(vertices, GL::BufferUsage::StaticDraw);
+        // Single (vectorized) conversion of the whole trajectory
+        const Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor> points = trajectory.cast<float>();
+        return this->trajectory(Eigen::Ref<const Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor>>(points), color_to_set);
+    }
 
-        // Index buffer
-        GL::Buffer index_buffer;
-        index_buffer.setData(indices);
+    objects::ObjectHandle3D& Graphics::trajectory(const Eigen::Ref<const Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor>>& trajectory, const std::string& color_to_set)
+    {
+        tools::Profiler::Section profile = _profiler.section("trajectory");
 
-        // Create mesh
-        GL::Mesh mesh;
-        mesh.setPrimitive(MeshPrimitive::Lines)
-            .setCount(indices.size())
-            .addVertexBuffer(std::move(vertex_buffer), 0, Shaders::VertexColorGL3D::Position{}, Shaders::VertexColorGL3D::Color3{})
-            .setIndexBuffer(std::move(index_buffer), 0, MeshIndexType::UnsignedShort);
+        // handle object
+        auto handle_obj = new objects::ObjectHandle3D(_manipulator, _drawables3D);
 
         // Create object connected to drawable
         auto it = _drawables3D.insert(std::make_pair(new objects::ObjectHandle3D(handle_obj, _drawables3D), nullptr));
@@ -210,48 +297,42 @@ namespace graphics_lib {
         // Add drawable
         if (it.second) {
             // Create drawable
-            it.first->second = Containers::pointer<drawables::ColorDrawable3D>(*it.first->first, _color3D, *_shadersManager.get<GL::AbstractShaderProgram, Shaders::VertexColorGL3D>("color3D"));
+            it.first->second = Containers::pointer<drawables::TrajectoryDrawable3D>(*it.first->first, _flat3D, *_shadersManager.get<GL::AbstractShaderProgram, Shaders::FlatGL3D>("flat3D"));
 
-            // Set drawable mesh
-            it.first->second->setMesh(mesh);
+            // Set color and upload trajectory (line strip, no index buffer)
+            static_cast<drawables::TrajectoryDrawable3D&>(*it.first->second).setColor(tools::color(color_to_set)).setTrajectory(trajectory, _quantization);
         }
 
         return *handle_obj;
     }
 
-    // Add primitive
-    objects::ObjectHandle3D& Graphics::primitive(const std::string& primitive)
+    // Add streaming trajectory
+    objects::ObjectHandle3D& Graphics::stream(const size_t& capacity, const std::string& color_to_set)
     {
-        // Default mesh cube
-        Trade::MeshData mesh_data = Primitives::cubeSolid();
+        tools::Profiler::Section profile = _profiler.section("stream");
 
-        if (!primitive.compare("sphere"))
-            mesh_data = Primitives::icosphereSolid(3);
-        else if (!primitive.compare("capsule"))
-            mesh_data = Primitives::capsule3DSolid(10, 10, 30, 0.5);
-        else if (!primitive.compare("cone"))
-            mesh_data = Primitives::coneSolid(10, 30, 1, Primitives::ConeFlag::CapEnd);
-        else if (!primitive.compare("cylinder"))
-            mesh_data = Primitives::cylinderSolid(10, 30, 1, Primitives::CylinderFlag::CapEnds);
+        // Create object
+        auto it = _drawables3D.insert(std::make_pair(new objects::ObjectHandle3D(_manipulator, _drawables3D), nullptr));
 
-        // Vertices
-        GL::Buffer vertices;
-        vertices.setData(MeshTools::interleave(mesh_data.positions3DAsArray(),
-            mesh_data.normalsAsArray()));
+        // Add drawable
+        if (it.second) {
+            // Create drawable (ring buffer allocated once here)
+            it.first->second = Containers::pointer<drawables::StreamDrawable3D>(*it.first->first, _flat3D, *_shadersManager.get<GL::AbstractShaderProgram, Shaders::FlatGL3D>("flat3D"), capacity);
 
-        // Indices
-        std::pair<Containers::Array<char>, MeshIndexType> compressed = MeshTools::compressIndices(mesh_data.indicesAsArray());
-        GL::Buffer indices;
-        indices.setData(compressed.first);
+            // Set color
+            static_cast<drawables::StreamDrawable3D&>(*it.first->second).setColor(tools::color(color_to_set));
+        }
 
-        // Mesh
-        GL::Mesh mesh;
-        mesh
-            .setPrimitive(mesh_data.primitive())
-            .setCount(mesh_data.indexCount())
-            .addVertexBuffer(std::move(vertices), 0, Shaders::PhongGL::Position{},
-                Shaders::PhongGL::Normal{})
-            .setIndexBuffer(std::move(indices), 0, compressed.second);
+        return *it.first->first;
+    }
+
+    // Add primitive
+    objects::ObjectHandle3D& Graphics::primitive(const std::string& primitive)
+    {
+        tools::Profiler::Section profile = _profiler.section("primitive");
+
+        // Mesh (shared)
+        Resource<GL::Mesh> mesh = primitiveMesh(primitive);
 
         // Create object
         auto it = _drawables3D.insert(std::make_pair(new objects::ObjectHandle3D(_manipulator, _drawables3D), nullptr));
@@ -262,46 +343,149 @@ namespace graphics_lib {
             it.first->second = Containers::pointer<drawables::PhongDrawable3D>(*it.first->first, _phong3D, *_shadersManager.get<GL::AbstractShaderProgram, Shaders::PhongGL>("phong"));
 
             // Set drawable mesh and default color
-            static_cast<drawables::PhongDrawable3D&>(it.first->second->setMesh(mesh)).setColor(0xffffff_rgbf);
+            static_cast<drawables::PhongDrawable3D&>(it.first->second->setMesh(mesh).setBoundingBox(primitiveBounds(primitive))).setColor(0xffffff_rgbf);
         }
 
         return *it.first->first;
     }
 
+    // Add instanced primitives
+    objects::ObjectHandle3D& Graphics::primitives(const std::string& primitive, const Eigen::Matrix<double, Eigen::Dynamic, 3>& positions, const Eigen::Matrix<double, Eigen::Dynamic, 3>& colors, const double& scale)
+    {
+        tools::Profiler::Section profile = _profiler.section("primitives");
+
+        std::pair<objects::ObjectHandle3D*, drawables::InstancedDrawable3D*> object = instanced(primitive);
+        if (object.second)
+            object.second->setInstances(positions, colors, scale);
+
+        return *object.first;
+    }
+
+    objects::ObjectHandle3D& Graphics::primitivesFromPoses(const std::string& primitive, const Eigen::Ref<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>& poses, const Eigen::Matrix<double, Eigen::Dynamic, 3>& colors)
+    {
+        tools::Profiler::Section profile = _profiler.section("primitivesFromPoses");
+
+        std::pair<objects::ObjectHandle3D*, drawables::InstancedDrawable3D*> object = instanced(primitive);
+        if (object.second)
+            object.second->setInstancePoses(poses, colors);
+
+        return *object.first;
+    }
+
+    std::pair<objects::ObjectHandle3D*, drawables::InstancedDrawable3D*> Graphics::instanced(const std::string& primitive)
+    {
+        // Create object
+        auto it = _drawables3D.insert(std::make_pair(new objects::ObjectHandle3D(_manipulator, _drawables3D), nullptr));
+        drawables::InstancedDrawable3D* instanced = nullptr;
+
+        // Add drawable
+        if (it.second) {
+            // Create drawable
+            auto drawable = Containers::pointer<drawables::InstancedDrawable3D>(*it.first->first, _instanced3D,
+                *_shadersManager.get<GL::AbstractShaderProgram, Shaders::PhongGL>("instanced"), *_shadersManager.get<GL::AbstractShaderProgram, Shaders::PhongGL>("instancedUniform"));
+
+            // Shared vertex/index buffers + per-instance attributes
+            const std::string key = primitiveKey(primitive);
+            Resource<GL::Mesh> shared = primitiveMesh(primitive);
+
+            GL::Mesh mesh;
+            mesh.setPrimitive(shared->primitive())
+                .setCount(shared->count())
+                .addVertexBuffer(*_resourcesManager.get<GL::Buffer>(key + "/vertices"), 0, Shaders::PhongGL::Position{}, Shaders::PhongGL::Normal{})
+                .setIndexBuffer(*_resourcesManager.get<GL::Buffer>(key + "/indices"), 0, shared->indexType())
+                .addVertexBufferInstanced(drawable->instanceBuffer(), 1, 0,
+                Shaders::PhongGL::TransformationMatrix{},
+                Shaders::PhongGL::NormalMatrix{},
+                Shaders::PhongGL::Color3{});
+
+            // Set drawable mesh (instances uploaded by the caller)
+            drawable->setMesh(mesh);
+            drawable->setInstanceBounds(primitiveBounds(primitive));
+
+            instanced = drawable.get();
+            it.first->second = std::move(drawable);
+        }
+
+        return {it.first->first, instanced};
+    }
+
     // Plot from vertices and indices matrices
-    objects::ObjectHandle3D& Graphics::surface(const Eigen::MatrixXd& vertices, const Eigen::VectorXd& function, const Eigen::MatrixXd& indices, const double& min, const double& max, const std::string& colorset)
+    objects::ObjectHandle3D& Graphics::surface(const Eigen::Ref<const Eigen::MatrixXd>& vertices, const Eigen::Ref<const Eigen::VectorXd>& function, const Eigen::Ref<const Eigen::MatrixXd>& indices, const double& min, const double& max, const std::string& colorset)
     {
-        // Colormap
-        const auto map = colormap(colorset);
+        tools::Profiler::Section profile = _profiler.section("surface (double)");
 
-        // Get colors for each value function
-        Eigen::VectorXi vertex2Color = tools::linearMap(function, min, max, map.size());
+        // Indices are checked before the conversion (out of range values cannot be cast to int)
+        if (vertices.cols() < 3 || indices.cols() < 3 || (indices.size() && !(indices.leftCols(3).minCoeff() >= 0 && indices.leftCols(3).maxCoeff() < vertices.rows()))) {
+            Warning{} << "Surface needs 3D vertices and triangle indices within the" << vertices.rows() << "vertices";
+            return *new objects::ObjectHandle3D(_manipulator, _drawables3D);
+        }
 
-        // Data structure (positions and colors interleaved)
-        struct VertexData {
-            Vector3 position;
-            Color3 color;
-        };
+        // Single (vectorized) conversion of each array
+        const Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor> positions = vertices.leftCols(3).cast<float>();
+        const Eigen::VectorXf values = function.cast<float>();
+        const Eigen::Matrix<int, Eigen::Dynamic, 3, Eigen::RowMajor> faces = indices.leftCols(3).cast<int>();
 
-        // Fill data structure
-        Containers::Array<VertexData> data;
-        for (size_t i = 0; i < indices.rows(); i++)
-            for (size_t j = 0; j < indices.cols(); j++) {
-                size_t index = indices(i, j);
-                Eigen::Vector3f vertex = vertices.row(index).cast<float>();
-                arrayAppend(data, Corrade::InPlaceInit, Vector3(vertex), Color3::fromSrgb(map[vertex2Color(index)]));
-            }
+        return surface(Eigen::Ref<const Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor>>(positions), Eigen::Ref<const Eigen::VectorXf>(values),
+            Eigen::Ref<const Eigen::Matrix<int, Eigen::Dynamic, 3, Eigen::RowMajor>>(faces), min, max, colorset);
+    }
 
-        // Create buffer
-        GL::Buffer buffer;
-        buffer.setData(data);
+    objects::ObjectHandle3D& Graphics::surface(const Eigen::Ref<const Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor>>& vertices, const Eigen::Ref<const Eigen::VectorXf>& function,
+        const Eigen::Ref<const Eigen::Matrix<int, Eigen::Dynamic, 3, Eigen::RowMajor>>& indices, const double& min, const double& max, const std::string& colorset)
+    {
+        tools::Profiler::Section profile = _profiler.section("surface");
 
-        // Create mesh
-        GL::Mesh mesh;
-        mesh.setCount(data.size())
-            .addVertexBuffer(std::move(buffer), 0,
-                Shaders::VertexColorGL3D::Position{},
-                Shaders::VertexColorGL3D::Color3{});
+        // Indices are read as unsigned by the GPU and the simplifier, one scalar per vertex (empty handle otherwise, as for failed imports)
+        if (function.size() != vertices.rows()) {
+            Warning{} << "Expected" << vertices.rows() << "surface scalars, got" << function.size();
+            return *new objects::ObjectHandle3D(_manipulator, _drawables3D);
+        }
+
+        if (indices.size() && (indices.minCoeff() < 0 || indices.maxCoeff() >= vertices.rows())) {
+            Warning{} << "Surface indices must be within the" << vertices.rows() << "vertices";
+            return *new objects::ObjectHandle3D(_manipulator, _drawables3D);
+        }
+
+        // Strided rows (e.g. blocks of wider matrices) are copied once, contiguous ones are read in place
+        Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor> vertices_copy;
+        const Float* vertex_data = vertices.data();
+        if (vertices.rows() > 1 && vertices.outerStride() != 3) {
+            vertices_copy = vertices;
+            vertex_data = vertices_copy.data();
+        }
+
+        Eigen::Matrix<int, Eigen::Dynamic, 3, Eigen::RowMajor> indices_copy;
+        const int* index_data = indices.data();
+        if (indices.rows() > 1 && indices.outerStride() != 3) {
+            indices_copy = indices;
+            index_data = indices_copy.data();
+        }
+
+        // Create buffers (positions uploaded as they are or quantized inside their bounds, non-negative indices read as unsigned)
+        const Containers::ArrayView<const Vector3> positions{reinterpret_cast<const Vector3*>(vertex_data), size_t(vertices.rows())};
+        const Range3D range = _quantization ? tools::quantizationRange(positions) : Range3D{};
+
+        GL::Buffer position_buffer;
+        if (_quantization) {
+            Containers::Array<Vector4us> quantized{Containers::NoInit, positions.size()};
+            tools::quantizePositions(positions, range, Containers::arrayView(quantized));
+            position_buffer.setData(quantized);
+        }
+        else
+            position_buffer.setData(positions);
+
+        const Containers::ArrayView<const UnsignedInt> faces{reinterpret_cast<const UnsignedInt*>(index_data), size_t(indices.size())};
+
+        // Simplified versions (vertices and thus scalars are shared with the full surface)
+        Containers::Array<tools::MeshLevel> levels;
+        if (_detailLevels && faces.size()) {
+            const Containers::Pair<Containers::ArrayView<const Vector3>, Containers::ArrayView<const UnsignedInt>> triangles{positions, faces};
+            levels = std::move(tools::MeshSimplifier{_detailLevels}.simplify({&triangles, 1})[0]);
+
+            // Errors in quantized units (the dequantization scales them back)
+            if (_quantization)
+                for (tools::MeshLevel& level : levels)
+                    level.error /= range.size().max();
+        }
 
         // Add object - drawable connection
         auto it = _drawables3D.insert(std::make_pair(new objects::ObjectHandle3D(_manipulator, _drawables3D), nullptr));
@@ -309,10 +493,69 @@ namespace graphics_lib {
         // Add drawable
         if (it.second) {
             // Create drawable
-            it.first->second = Containers::pointer<drawables::ColorDrawable3D>(*it.first->first, _color3D, *_shadersManager.get<GL::AbstractShaderProgram, Shaders::VertexColorGL3D>("color3D"));
+            auto drawable = Containers::pointer<drawables::ScalarDrawable3D>(*it.first->first, _scalar3D, *_shadersManager.get<GL::AbstractShaderProgram, shaders::ScalarColorGL3D>("scalar3D"));
+
+            // Upload scalars into the drawable buffer (colormapping happens in the shader)
+            drawable->setColormap(colormapTexture(colorset)).setRange(min, max).setVertexCount(vertices.rows()).updateField(function);
+
+            // Create mesh (positions and scalars in separate buffers)
+            GL::Mesh mesh;
+            if (_quantization)
+                mesh.addVertexBuffer(std::move(position_buffer), 0, shaders::ScalarColorGL3D::Position{shaders::ScalarColorGL3D::Position::DataType::UnsignedShort, shaders::ScalarColorGL3D::Position::DataOption::Normalized}, 2);
+            else
+                mesh.addVertexBuffer(std::move(position_buffer), 0, shaders::ScalarColorGL3D::Position{});
+
+            mesh.addVertexBuffer(drawable->scalarBuffer(), 0, shaders::ScalarColorGL3D::Scalar{});
+
+            // Full triangle list followed by the levels (32-bit), or compressed indices alone
+            if (!levels.isEmpty())
+                drawable->setDetailLevels(addDetailLevels(mesh, faces, levels));
+            else {
+                std::pair<Containers::Array<char>, MeshIndexType> compressed = MeshTools::compressIndices(faces);
+                GL::Buffer index_buffer;
+                index_buffer.setData(compressed.first);
+
+                mesh.setCount(faces.size())
+                    .setIndexBuffer(std::move(index_buffer), 0, compressed.second);
+            }
+
+            // Set drawable mesh and bounds (quantized positions span the unit box)
+            drawable->setMesh(mesh);
+            if (_quantization)
+                drawable->setBoundingBox(Range3D{Vector3{0.0f}, Vector3{1.0f}}).addPriorTransformation(tools::dequantization(range));
+            else if (vertices.rows()) {
+                const Eigen::Vector3f lower = vertices.colwise().minCoeff(), upper = vertices.colwise().maxCoeff();
+                drawable->setBoundingBox({Vector3(lower), Vector3(upper)});
+            }
+
+            it.first->second = std::move(drawable);
+        }
+
+        return *it.first->first;
+    }
+
+    objects::ObjectHandle3D& Graphics::pointCloud(const Eigen::Matrix<double, Eigen::Dynamic, 3>& positions, const Eigen::VectorXd& scalars, const std::string& colorset)
+    {
+        tools::Profiler::Section profile = _profiler.section("pointCloud");
+
+        // Color by elevation if no scalars are given
+        const Eigen::VectorXd field = scalars.size() ? scalars : Eigen::VectorXd(positions.col(2));
+
+        // Add object - drawable connection
+        auto it = _drawables3D.insert(std::make_pair(new objects::ObjectHandle3D(_manipulator, _drawables3D), nullptr));
+
+        // Add drawable
+        if (it.second) {
+            // Create drawable (octree built here)
+            auto drawable = Containers::pointer<drawables::PointCloudDrawable3D>(*it.first->first, _scalar3D, *_shadersManager.get<GL::AbstractShaderProgram, shaders::ScalarColorGL3D>("scalar3D"));
+
+            drawable->setPoints(positions);
+            drawable->setColormap(colormapTexture(colorset));
 
-            // Set drawable mesh
-            it.first->second->setMesh(mesh);
+            if (field.size())
+                drawable->setRange(field.minCoeff(), field.maxCoeff()).updateField(field);
+
+            it.first->second = std::move(drawable);
         }
 
         return *it.first->first;
@@ -320,238 +563,939 @@ namespace graphics_lib {
 
     objects::ObjectHandle3D& Graphics::import(const std::string& file, const std::string& importer)
     {
+        tools::Profiler::Section profile = _profiler.section("import");
+
         // Set importer
         if (!importer.empty())
             _importer = _manager.loadAndInstantiate(importer);
 
-        // Check importer & file
-        if (!_importer || !_importer->openFile(file))
+        // Parse file & prepare data (textures already uploaded by a previous import are not decoded again)
+        ImportJob job;
+        job.file = file;
+        job.quantization = _quantization;
+        if (!_importer || !load(*_importer, file, job.data, [this, &file](UnsignedInt id) { return _resourcesManager.state<GL::Texture2D>(textureKey(file, id)) == ResourceState::Final; }))
             std::exit(1);
 
+        if (_detailLevels)
+            simplify(job.data, _detailLevels);
+
+        // Handle object to control all the objects loaded from the file
+        job.handle = new objects::ObjectHandle3D(_manipulator, _drawables3D);
+
+        // Upload everything at once
+        upload(job, std::numeric_limits<size_t>::max());
+
+        return *job.handle;
+    }
+
+    objects::ObjectHandle3D& Graphics::importAsync(const std::string& file, const std::string& importer, std::function<void(objects::ObjectHandle3D&, const float&)> progress, std::function<void(objects::ObjectHandle3D&)> completion)
+    {
+        tools::Profiler::Section profile = _profiler.section("importAsync");
+
+        auto job = Containers::pointer<ImportJob>();
+
+        // Placeholder handle (objects are attached to it as soon as they are uploaded)
+        job->handle = new objects::ObjectHandle3D(_manipulator, _drawables3D);
+        job->file = file;
+        job->quantization = _quantization;
+        job->progress = std::move(progress);
+        job->completion = std::move(completion);
+
+        // Each job gets its own plugin manager and importer: the format plugins loaded by AnySceneImporter while opening
+        // the file on the worker thread never go through the manager shared with the main thread
+        job->manager = Containers::pointer<PluginManager::Manager<Trade::AbstractImporter>>();
+        job->importer = job->manager->loadAndInstantiate(importer.empty() ? "AnySceneImporter" : importer);
+
+        if (!job->importer) {
+            Warning{} << "Cannot instantiate importer for" << file.c_str();
+            return *job->handle;
+        }
+
+        // Parse & decode on a worker thread
+        ImportJob* ptr = job.get();
+        job->loaded = std::async(std::launch::async, [this, ptr, file, levels = _detailLevels]() {
+            if (!load(*ptr->importer, file, ptr->data))
+                return false;
+
+            if (levels)
+                simplify(ptr->data, levels);
+
+            return true;
+        });
+
+        objects::ObjectHandle3D& handle = *job->handle;
+        _imports.push_back(std::move(job));
+
+        return handle;
+    }
+
+    bool Graphics::load(Trade::AbstractImporter& importer, const std::string& file, ImportData& data, const std::function<bool(UnsignedInt)>& resident) const
+    {
+        // Try the cache first (no parsing at all if the file did not change)
+        const std::string cache = _cacheDirectory.empty() ? std::string{} : cacheFile(file);
+        if (!cache.empty()) {
+            if (loadCache(cache, data))
+                return true;
+            data = ImportData{};
+        }
+
+        // Check file
+        if (!importer.openFile(file))
+            return false;
+
+        // The cache can be written only if all the images have been decoded
+        bool complete = true;
+
         /* Textures */
-        Containers::Array<Containers::Optional<GL::Texture2D>> textures{_importer->textureCount()};
-        for (UnsignedInt i = 0; i != _importer->textureCount(); ++i) {
-            Containers::Optional<Trade::TextureData> textureData = _importer->texture(i);
+        data.textures = Containers::Array<Containers::Optional<Trade::TextureData>>{importer.textureCount()};
+        data.images = Containers::Array<Containers::Optional<Trade::ImageData2D>>{importer.textureCount()};
+        for (UnsignedInt i = 0; i != importer.textureCount(); ++i) {
+            Containers::Optional<Trade::TextureData> textureData = importer.texture(i);
             if (!textureData || textureData->type() != Trade::TextureType::Texture2D) {
-                Warning{} << "Cannot load texture" << i << _importer->textureName(i);
+                Warning{} << "Cannot load texture" << i << importer.textureName(i);
+                continue;
+            }
+
+            // Already on the GPU
+            if (resident && resident(i)) {
+                data.textures[i] = std::move(textureData);
+                complete = false;
                 continue;
             }
 
-            Containers::Optional<Trade::ImageData2D> imageData = _importer->image2D(textureData->image());
-            if (!imageData || !imageData->isCompressed()) {
-                Warning{} << "Cannot load image" << textureData->image() << _importer->image2DName(textureData->image());
+            Containers::Optional<Trade::ImageData2D> imageData = importer.image2D(textureData->image());
+            if (!imageData) {
+                Warning{} << "Cannot load image" << textureData->image() << importer.image2DName(textureData->image());
                 continue;
             }
 
-            (*(textures[i] = GL::Texture2D{}))
-                .setMagnificationFilter(textureData->magnificationFilter())
-                .setMinificationFilter(textureData->minificationFilter(),
-                    textureData->mipmapFilter())
-                .setWrapping(textureData->wrapping().xy())
-                .setStorage(Math::log2(imageData->size().max()) + 1,
-                    GL::textureFormat(imageData->format()), imageData->size())
-                .setSubImage(0, {}, *imageData)
-                .generateMipmap();
+            data.textures[i] = std::move(textureData);
+            data.images[i] = std::move(imageData);
         }
 
         /* Materials */
-        Containers::Array<Containers::Optional<Trade::PhongMaterialData>> materials{_importer->materialCount()};
-        for (UnsignedInt i = 0; i != _importer->materialCount(); ++i) {
+        data.materials = Containers::Array<Containers::Optional<Trade::PhongMaterialData>>{importer.materialCount()};
+        for (UnsignedInt i = 0; i != importer.materialCount(); ++i) {
             Containers::Optional<Trade::MaterialData> materialData;
-            if (!(materialData = _importer->material(i))) {
-                Warning{} << "Cannot load material" << i << _importer->materialName(i);
+            if (!(materialData = importer.material(i))) {
+                Warning{} << "Cannot load material" << i << importer.materialName(i);
                 continue;
             }
 
-            materials[i] = std::move(*materialData).as<Trade::PhongMaterialData>();
+            data.materials[i] = std::move(*materialData).as<Trade::PhongMaterialData>();
         }
 
         /* Meshes */
-        Containers::Array<Containers::Optional<GL::Mesh>> meshes{_importer->meshCount()};
+        data.meshes = Containers::Array<Containers::Optional<Trade::MeshData>>{importer.meshCount()};
+        for (UnsignedInt i = 0; i != importer.meshCount(); ++i) {
+            if (!(data.meshes[i] = importer.mesh(i)))
+                Warning{} << "Cannot load mesh" << i << importer.meshName(i);
+        }
+
+        /* The format has no scene support, only the first mesh will be displayed */
+        data.hasScene = importer.defaultScene() != -1;
+        if (!data.hasScene) {
+            if (!cache.empty() && complete && !saveCache(cache, data))
+                Warning{} << "Cannot write cache" << cache.c_str();
+            return true;
+        }
+
+        /* Load the scene */
+        Containers::Optional<Trade::SceneData> scene;
+        if (!(scene = importer.scene(importer.defaultScene())) || !scene->is3D() || !scene->hasField(Trade::SceneField::Parent) || !scene->hasField(Trade::SceneField::Mesh)) {
+            Error{} << "Cannot load scene" << importer.defaultScene() << importer.sceneName(importer.defaultScene());
+            return false;
+        }
+
+        data.mappingBound = scene->mappingBound();
+        data.parents = scene->parentsAsArray();
+        data.meshesMaterials = scene->meshesMaterialsAsArray();
+        data.transformations = scene->transformations3DAsArray();
+
+        if (!cache.empty() && complete && !saveCache(cache, data))
+            Warning{} << "Cannot write cache" << cache.c_str();
 
-        for (UnsignedInt i = 0; i != _importer->meshCount(); ++i) {
-            Containers::Optional<Trade::MeshData> meshData;
-            if (!(meshData = _importer->mesh(i))) {
-                Warning{} << "Cannot load mesh" << i << _importer->meshName(i);
+        return true;
+    }
+
+    void Graphics::simplify(ImportData& data, const size_t& levels) const
+    {
+        // Positions and triangle lists of the meshes (non-indexed meshes index their vertices in order)
+        Containers::Array<Containers::Array<Vector3>> positions{data.meshes.size()};
+        Containers::Array<Containers::Array<UnsignedInt>> indices{data.meshes.size()};
+        Containers::Array<Containers::Pair<Containers::ArrayView<const Vector3>, Containers::ArrayView<const UnsignedInt>>> meshes{data.meshes.size()};
+
+        for (size_t i = 0; i < data.meshes.size(); ++i) {
+            const Containers::Optional<Trade::MeshData>& mesh = data.meshes[i];
+            if (!mesh || mesh->primitive() != MeshPrimitive::Triangles || !mesh->hasAttribute(Trade::MeshAttribute::Position))
                 continue;
+
+            positions[i] = mesh->positions3DAsArray();
+
+            if (mesh->isIndexed())
+                indices[i] = mesh->indicesAsArray();
+            else {
+                indices[i] = Containers::Array<UnsignedInt>{Containers::NoInit, mesh->vertexCount()};
+                for (UnsignedInt j = 0; j < indices[i].size(); ++j)
+                    indices[i][j] = j;
+            }
+
+            meshes[i] = {positions[i], indices[i]};
+        }
+
+        data.levels = tools::MeshSimplifier{levels}.simplify(meshes);
+    }
+
+    Containers::Array<drawables::DetailLevel> Graphics::addDetailLevels(GL::Mesh& mesh, Containers::ArrayView<const UnsignedInt> indices, Containers::ArrayView<const tools::MeshLevel> levels) const
+    {
+        Containers::Array<drawables::DetailLevel> ranges{Containers::NoInit, levels.size()};
+
+        // Full triangle list followed by the levels (32-bit, offsets are in indices)
+        size_t count = indices.size();
+        for (const tools::MeshLevel& level : levels)
+            count += level.indices.size();
+
+        Containers::Array<UnsignedInt> data{Containers::NoInit, count};
+        Utility::copy(indices, data.prefix(indices.size()));
+
+        size_t offset = indices.size();
+        for (size_t i = 0; i < levels.size(); ++i) {
+            Utility::copy(levels[i].indices, data.slice(offset, offset + levels[i].indices.size()));
+            ranges[i] = drawables::DetailLevel{UnsignedInt(offset), UnsignedInt(levels[i].indices.size()), levels[i].error};
+            offset += levels[i].indices.size();
+        }
+
+        GL::Buffer buffer;
+        buffer.setData(data);
+
+        // The full mesh is still drawn by default
+        mesh.setIndexBuffer(std::move(buffer), 0, MeshIndexType::UnsignedInt)
+            .setCount(indices.size());
+
+        return ranges;
+    }
+
+    Trade::MeshData Graphics::quantize(const Trade::MeshData& mesh, const Range3D& range) const
+    {
+        const UnsignedInt vertexCount = mesh.vertexCount();
+        const bool normals = mesh.hasAttribute(Trade::MeshAttribute::Normal),
+                   coordinates = mesh.hasAttribute(Trade::MeshAttribute::TextureCoordinates),
+                   colors = mesh.hasAttribute(Trade::MeshAttribute::Color);
+
+        // Interleaved layout: position (8 bytes), normal (4 bytes), texture coordinates (kept as floats, may wrap), color (4 bytes)
+        const std::size_t normalOffset = sizeof(Vector4us),
+                          coordinatesOffset = normalOffset + (normals ? sizeof(Vector4b) : 0),
+                          colorOffset = coordinatesOffset + (coordinates ? sizeof(Vector2) : 0),
+                          stride = colorOffset + (colors ? sizeof(Color4ub) : 0);
+
+        Containers::Array<char> vertexData{Containers::ValueInit, stride * vertexCount};
+        Containers::Array<Trade::MeshAttributeData> attributes{1 + std::size_t(normals) + std::size_t(coordinates) + std::size_t(colors)};
+        std::size_t attribute = 0;
+
+        const Containers::StridedArrayView1D<Vector4us> positions{vertexData, reinterpret_cast<Vector4us*>(vertexData.data()), vertexCount, std::ptrdiff_t(stride)};
+        tools::quantizePositions(Containers::arrayView(mesh.positions3DAsArray()), range, positions);
+        attributes[attribute++] = Trade::MeshAttributeData{Trade::MeshAttribute::Position, VertexFormat::Vector3usNormalized, positions};
+
+        if (normals) {
+            const Containers::StridedArrayView1D<Vector4b> view{vertexData, reinterpret_cast<Vector4b*>(vertexData.data() + normalOffset), vertexCount, std::ptrdiff_t(stride)};
+            tools::quantizeNormals(Containers::arrayView(mesh.normalsAsArray()), range, view);
+            attributes[attribute++] = Trade::MeshAttributeData{Trade::MeshAttribute::Normal, VertexFormat::Vector3bNormalized, view};
+        }
+
+        if (coordinates) {
+            const Containers::StridedArrayView1D<Vector2> view{vertexData, reinterpret_cast<Vector2*>(vertexData.data() + coordinatesOffset), vertexCount, std::ptrdiff_t(stride)};
+            mesh.textureCoordinates2DInto(view);
+            attributes[attribute++] = Trade::MeshAttributeData{Trade::MeshAttribute::TextureCoordinates, VertexFormat::Vector2, view};
+        }
+
+        if (colors) {
+            const Containers::StridedArrayView1D<Color4ub> view{vertexData, reinterpret_cast<Color4ub*>(vertexData.data() + colorOffset), vertexCount, std::ptrdiff_t(stride)};
+            const Containers::Array<Color4> source = mesh.colorsAsArray();
+            for (UnsignedInt i = 0; i < vertexCount; ++i)
+                view[i] = Math::pack<Color4ub>(source[i]);
+            attributes[attribute++] = Trade::MeshAttributeData{Trade::MeshAttribute::Color, VertexFormat::Vector4ubNormalized, view};
+        }
+
+        // Indices copied as they are
+        Containers::Array<char> indexData;
+        Trade::MeshIndexData indices;
+        if (mesh.isIndexed()) {
+            indexData = Containers::Array<char>{Containers::NoInit, mesh.indexData().size()};
+            Utility::copy(mesh.indexData(), indexData);
+            indices = Trade::MeshIndexData{mesh.indexType(), indexData.slice(mesh.indexOffset(), mesh.indexOffset() + mesh.indexCount() * meshIndexTypeSize(mesh.indexType()))};
+        }
+
+        return Trade::MeshData{mesh.primitive(), std::move(indexData), indices, std::move(vertexData), std::move(attributes), vertexCount};
+    }
+
+    bool Graphics::upload(ImportJob& job, size_t budget)
+    {
+        ImportData& data = job.data;
+        const size_t textureCount = data.textures.size(), meshCount = data.meshes.size(), total = textureCount + meshCount + 1;
+
+        if (job.textures.isEmpty() && textureCount)
+            job.textures = Containers::Array<Resource<GL::Texture2D>>{textureCount};
+        if (job.meshes.isEmpty() && meshCount) {
+            job.meshes = Containers::Array<Containers::Optional<GL::Mesh>>{meshCount};
+            job.bounds = Containers::Array<Containers::Optional<Range3D>>{meshCount};
+            job.levels = Containers::Array<Containers::Array<drawables::DetailLevel>>{meshCount};
+            job.dequantizations = Containers::Array<Containers::Optional<Matrix4>>{meshCount};
+        }
+
+        for (; budget && job.step < total; --budget, ++job.step) {
+            /* Textures */
+            if (job.step < textureCount) {
+                const size_t i = job.step;
+                const std::string key = textureKey(job.file, i);
+
+                // Uploaded once and shared by all the drawables (and imports) using it
+                job.textures[i] = _resourcesManager.get<GL::Texture2D>(key);
+                if (job.textures[i] || !data.textures[i] || !data.images[i])
+                    continue;
+
+                Trade::TextureData& textureData = *data.textures[i];
+                Trade::ImageData2D& imageData = *data.images[i];
+
+                auto texture = new GL::Texture2D;
+                texture->setMagnificationFilter(textureData.magnificationFilter())
+                    .setMinificationFilter(textureData.minificationFilter(),
+                        textureData.mipmapFilter())
+                    .setWrapping(textureData.wrapping().xy());
+
+                // Keep GPU compressed formats compressed (single level, mipmaps cannot be generated)
+                if (imageData.isCompressed())
+                    texture->setStorage(1, GL::textureFormat(imageData.compressedFormat()), imageData.size())
+                        .setCompressedSubImage(0, {}, imageData);
+                else
+                    texture->setStorage(Math::log2(imageData.size().max()) + 1,
+                                GL::textureFormat(imageData.format()), imageData.size())
+                        .setSubImage(0, {}, imageData)
+                        .generateMipmap();
+
+                // Released once the last drawable using it is gone
+                _resourcesManager.set(key, texture, ResourceDataState::Final, ResourcePolicy::ReferenceCounted);
+
+                // CPU copy not needed anymore
+                data.images[i] = Containers::NullOpt;
             }
+            /* Meshes */
+            else if (job.step < textureCount + meshCount) {
+                const size_t i = job.step - textureCount;
+                if (!data.meshes[i])
+                    continue;
+
+                // Bounds (culling)
+                if (data.meshes[i]->hasAttribute(Trade::MeshAttribute::Position) && data.meshes[i]->vertexCount()) {
+                    const Containers::Array<Vector3> positions = data.meshes[i]->positions3DAsArray();
+                    Range3D box{positions[0], positions[0]};
+                    for (const Vector3& position : positions)
+                        box = Range3D{Math::min(box.min(), position), Math::max(box.max(), position)};
+                    job.bounds[i] = box;
+
+                    // Compact attributes (positions inside the bounds, mapped back by a prior transformation of the drawables)
+                    if (job.quantization) {
+                        const Range3D range = tools::quantizationRange(Containers::arrayView(positions));
+                        Trade::MeshData quantized = quantize(*data.meshes[i], range);
+                        data.meshes[i] = Containers::optional(std::move(quantized));
+                        job.bounds[i] = Range3D{Vector3{0.0f}, Vector3{1.0f}};
+                        job.dequantizations[i] = tools::dequantization(range);
+
+                        if (i < data.levels.size())
+                            for (tools::MeshLevel& level : data.levels[i])
+                                level.error /= range.size().max();
+                    }
+                }
+
+                MeshTools::CompileFlags flags;
+                if (data.meshes[i]->hasAttribute(Trade::MeshAttribute::Normal))
+                    flags |= MeshTools::CompileFlag::GenerateFlatNormals;
+                job.meshes[i] = MeshTools::compile(*data.meshes[i], flags);
+
+                // Simplified versions share the vertices of the full mesh
+                if (i < data.levels.size() && !data.levels[i].isEmpty()) {
+                    Containers::Array<UnsignedInt> indices;
+                    if (data.meshes[i]->isIndexed())
+                        indices = data.meshes[i]->indicesAsArray();
+                    else {
+                        indices = Containers::Array<UnsignedInt>{Containers::NoInit, data.meshes[i]->vertexCount()};
+                        for (UnsignedInt j = 0; j < indices.size(); ++j)
+                            indices[j] = j;
+                    }
+
+                    job.levels[i] = addDetailLevels(*job.meshes[i], indices, data.levels[i]);
+                    data.levels[i] = {};
+                }
 
-            MeshTools::CompileFlags flags;
-            if (meshData->hasAttribute(Trade::MeshAttribute::Normal))
-                flags |= MeshTools::CompileFlag::GenerateFlatNormals;
-            meshes[i] = MeshTools::compile(*meshData, flags);
+                // CPU copy not needed anymore
+                data.meshes[i] = Containers::NullOpt;
+            }
+            /* Objects & drawables */
+            else
+                addImported(job);
         }
 
+        if (job.progress)
+            job.progress(*job.handle, Float(job.step) / total);
+
+        return job.step == total;
+    }
+
+    void Graphics::addImported(ImportJob& job)
+    {
+        ImportData& data = job.data;
+        Containers::Array<Resource<GL::Texture2D>>& textures = job.textures;
+        Containers::Array<Containers::Optional<GL::Mesh>>& meshes = job.meshes;
+
         /* The format has no scene support, display just the first loaded mesh with
            a default material (if it's there) and be done with it. */
-        if (_importer->defaultScene() == -1) {
+        if (!data.hasScene) {
             if (!meshes.isEmpty() && meshes[0]) {
-                auto it = _drawables3D.insert(std::make_pair(new objects::ObjectHandle3D(_manipulator, _drawables3D), nullptr));
+                auto it = _drawables3D.insert(std::make_pair(new objects::ObjectHandle3D(job.handle, _drawables3D), nullptr));
                 if (it.second) {
                     it.first->second = Containers::pointer<drawables::PhongDrawable3D>(*it.first->first, _phong3D, *_shadersManager.get<GL::AbstractShaderProgram, Shaders::PhongGL>("phong"));
-                    static_cast<drawables::PhongDrawable3D&>(it.first->second->setMesh(*meshes[0])).setColor(0xffffff_rgbf);
+                    static_cast<drawables::PhongDrawable3D&>(it.first->second->setMesh(*meshes[0]).setDetailLevels(job.levels[0])).setColor(0xffffff_rgbf);
+                    if (job.bounds[0])
+                        it.first->second->setBoundingBox(*job.bounds[0]);
+                    if (job.dequantizations[0])
+                        it.first->second->addPriorTransformation(*job.dequantizations[0]);
                 }
-                return *it.first->first;
             }
-            return *_manipulator;
+            return;
         }
 
-        /* Load the scene */
-        Containers::Optional<Trade::SceneData> scene;
-        if (!(scene = _importer->scene(_importer->defaultScene())) || !scene->is3D() || !scene->hasField(Trade::SceneField::Parent) || !scene->hasField(Trade::SceneField::Mesh))
-            Fatal{} << "Cannot load scene" << _importer->defaultScene() << _importer->sceneName(_importer->defaultScene());
-
         /* Allocate objects that are part of the hierarchy & assign parent references*/
-        Containers::Array<objects::ObjectHandle3D*> objects{std::size_t(scene->mappingBound())};
-        Containers::Array<Containers::Pair<UnsignedInt, Int>> parents = scene->parentsAsArray();
+        Containers::Array<objects::ObjectHandle3D*> objects{data.mappingBound};
 
-        // Here we create a handle object to control all the ones loaded from the file
-        // without having to pass through the manipulator object
-        auto handle_object = new objects::ObjectHandle3D(_manipulator, _drawables3D);
+        for (const Containers::Pair<UnsignedInt, Int>& parent : data.parents)
+            objects[parent.first()] = new objects::ObjectHandle3D{parent.second() == -1 ? job.handle : objects[parent.second()], _drawables3D};
 
-        for (const Containers::Pair<UnsignedInt, Int>& parent : parents) {
-            // std::cout << "Object: " << parent.first() << std::endl;
-            // std::cout << "Parent: " << parent.second() << std::endl;
-            objects[parent.first()] = new objects::ObjectHandle3D{parent.second() == -1 ? handle_object : objects[parent.second()], _drawables3D};
-        }
+        // Materials of the file (shared by the parts, released with the last drawable using them)
+        Containers::Array<Resource<Trade::PhongMaterialData>> materials{data.materials.size()};
 
         /* Add drawables for objects that have a mesh, again ignoring objects that
            are not part of the hierarchy. There can be multiple mesh assignments
            for one object, simply add one drawable for each. */
-        for (const Containers::Pair<UnsignedInt, Containers::Pair<UnsignedInt, Int>>& meshMaterial : scene->meshesMaterialsAsArray()) {
+        for (const Containers::Pair<UnsignedInt, Containers::Pair<UnsignedInt, Int>>& meshMaterial : data.meshesMaterials) {
 
             objects::ObjectHandle3D* object = objects[meshMaterial.first()];
-            auto it = _drawables3D.insert(std::make_pair(object, nullptr));
-            if (!it.second)
-                Fatal{} << "Cannot add object to drawables";
-
             Containers::Optional<GL::Mesh>& mesh = meshes[meshMaterial.second().first()];
+            const Containers::Optional<Range3D>& bounds = job.bounds[meshMaterial.second().first()];
             if (!object || !mesh)
                 continue;
 
+            auto it = _drawables3D.insert(std::make_pair(object, nullptr));
+            if (!it.second)
+                Fatal{} << "Cannot add object to drawables";
+
             Int materialId = meshMaterial.second().second();
 
+            // Materials are registered once per file and shared by all the objects using them
+            Resource<Trade::PhongMaterialData> material;
+            if (materialId != -1) {
+                material = _resourcesManager.get<Trade::PhongMaterialData>(materialKey(job.file, materialId));
+                if (!material && data.materials[materialId])
+                    _resourcesManager.set(material.key(), new Trade::PhongMaterialData{std::move(*data.materials[materialId])}, ResourceDataState::Final, ResourcePolicy::ReferenceCounted);
+
+                // Referenced until the end of the import (parts sharing it), then by the drawables using it
+                materials[materialId] = material;
+            }
+
             /* Material not available / not loaded, use a default material */
-            if (materialId == -1 || !materials[materialId]) {
+            if (!material) {
                 it.first->second = Containers::pointer<drawables::PhongDrawable3D>(*it.first->first, _phong3D, *_shadersManager.get<GL::AbstractShaderProgram, Shaders::PhongGL>("phong"));
                 static_cast<drawables::PhongDrawable3D&>(it.first->second->setMesh(*mesh))
                     .setColor(0xffffff_rgbf); // Default color
             }
             /* Textured material, if the texture loaded correctly */
-            else if (materials[materialId]->hasAttribute(Trade::MaterialAttribute::DiffuseTexture) && textures[materials[materialId]->diffuseTexture()]) {
+            else if (material->hasAttribute(Trade::MaterialAttribute::DiffuseTexture) && textures[material->diffuseTexture()]) {
                 it.first->second = Containers::pointer<drawables::TextureDrawable3D>(*it.first->first, _texture3D, *_shadersManager.get<GL::AbstractShaderProgram, Shaders::PhongGL>("texture"));
                 static_cast<drawables::TextureDrawable3D&>(it.first->second->setMesh(*mesh))
-                    .setTexture(*textures[materials[materialId]->diffuseTexture()]);
+                    .setTexture(textures[material->diffuseTexture()]);
             }
             /* Color-only material */
             else {
                 it.first->second = Containers::pointer<drawables::PhongDrawable3D>(*it.first->first, _phong3D, *_shadersManager.get<GL::AbstractShaderProgram, Shaders::PhongGL>("phong"));
                 static_cast<drawables::PhongDrawable3D&>(it.first->second->setMesh(*mesh))
-                    .setColor(materials[materialId]->diffuseColor()); // set color by default but it should not be used
-                                                                      // .setMaterial(*materials[materialId]) // correct here (check with reference example)
+                    .setMaterial(material)
+                    .setColor(material->diffuseColor()); // set color by default but it should not be used
+                                                                      // .setMaterial(*material) // correct here (check with reference example)
             }
+
+            if (bounds)
+                it.first->second->setBoundingBox(*bounds);
+            if (const Containers::Optional<Matrix4>& dequantization = job.dequantizations[meshMaterial.second().first()])
+                it.first->second->addPriorTransformation(*dequantization);
+
+            it.first->second->setDetailLevels(job.levels[meshMaterial.second().first()]);
         }
 
         /* Set transformations. Objects that are not part of the hierarchy are
            ignored, objects that have no transformation entry retain an identity
            transformation. */
-        for (const Containers::Pair<UnsignedInt, Matrix4>& transformation : scene->transformations3DAsArray()) {
+        for (const Containers::Pair<UnsignedInt, Matrix4>& transformation : data.transformations) {
             if (objects::ObjectHandle3D* object = objects[transformation.first()])
                 object->addPriorTransformation(transformation.second());
         }
+    }
+
+    void Graphics::processImports()
+    {
+        for (size_t i = 0; i < _imports.size();) {
+            ImportJob& job = *_imports[i];
+
+            // Still parsing
+            if (job.loaded.valid()) {
+                if (job.loaded.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                    ++i;
+                    continue;
+                }
+
+                if (!job.loaded.get()) {
+                    Warning{} << "Cannot import file";
+                    _imports.erase(_imports.begin() + i);
+                    continue;
+                }
+            }
+
+            // Spread the GL uploads across frames
+            if (upload(job, ImportUploadsPerFrame)) {
+                if (job.completion)
+                    job.completion(*job.handle);
+                _imports.erase(_imports.begin() + i);
+            }
+            else
+                ++i;
+        }
+    }
 
-        return *handle_object;
+    Graphics& Graphics::post(objects::ObjectHandle3D& object, const Matrix4& transformation)
+    {
+        _commands.push(Command{&object, transformation, {}});
+        _changed = true;
+
+        return *this;
     }
 
-    objects::ObjectHandle2D& Graphics::colorbar(const double& min, const double& max, const std::string& colorset)
+    Graphics& Graphics::post(std::function<void(Graphics&)> call)
     {
-        // Map
-        const auto map = colormap(colorset);
+        _commands.push(Command{nullptr, {}, std::move(call)});
+        _changed = true;
 
-        // Ticks
-        Eigen::Matrix<double, 10, 1> ticks = Eigen::VectorXd::LinSpaced(10, min, max);
+        return *this;
+    }
 
-        // Colors
-        Eigen::Matrix<int, 10, 1> colors_index = Eigen::VectorXi::LinSpaced(10, 0, 255);
+    void Graphics::processCommands()
+    {
+        // Newest pose per object
+        const auto applyPoses = [this]() {
+            for (auto& pose : _posted)
+                pose.first->setTransformation(pose.second);
 
-        // Vertices
-        struct VertexData {
-            Vector2 position;
-            Color3 color;
+            _posted.clear();
         };
 
-        Containers::Array<VertexData> vertices;
-        for (size_t i = 0; i < 9; i++) {
-            // lower triangle
-            arrayAppend(vertices, Corrade::InPlaceInit, 0.5 * Vector2{0, float(i) - 1}, Color3::fromSrgb(map[colors_index[i]]));
-            arrayAppend(vertices, Corrade::InPlaceInit, 0.5 * Vector2{1, float(i) - 1}, Color3::fromSrgb(map[colors_index[i]]));
-            arrayAppend(vertices, Corrade::InPlaceInit, 0.5 * Vector2{1, float(i + 1) - 1}, Color3::fromSrgb(map[colors_index[i + 1]]));
+        // Calls run in order, poses are coalesced until the next call (which sees every pose posted before it)
+        _commands.drain([&](Command& command) {
+            if (command.object)
+                _posted[command.object] = command.transformation;
+            else if (command.call) {
+                applyPoses();
+                command.call(*this);
+            }
+        });
 
-            // upper triangle
-            arrayAppend(vertices, Corrade::InPlaceInit, 0.5 * Vector2{0, float(i) - 1}, Color3::fromSrgb(map[colors_index[i]]));
-            arrayAppend(vertices, Corrade::InPlaceInit, 0.5 * Vector2{1, float(i + 1) - 1}, Color3::fromSrgb(map[colors_index[i + 1]]));
-            arrayAppend(vertices, Corrade::InPlaceInit, 0.5 * Vector2{0, float(i + 1) - 1}, Color3::fromSrgb(map[colors_index[i + 1]]));
-        }
+        applyPoses();
+    }
 
-        // Mesh
-        GL::Mesh mesh;
-        mesh.setCount(Containers::arraySize(vertices))
-            .addVertexBuffer(GL::Buffer{vertices}, 0,
-                Shaders::VertexColorGL2D::Position{},
-                Shaders::VertexColorGL2D::Color3{});
+    objects::PoseBatch Graphics::bind(const std::vector<objects::ObjectHandle3D*>& handles) const
+    {
+        return objects::PoseBatch{handles};
+    }
+
+    objects::ObjectHandle2D& Graphics::colorbar(const double& min, const double& max, const std::string& colorset)
+    {
+        tools::Profiler::Section profile = _profiler.section("colorbar");
+
+        // Vertices (single quad, the scalar is interpolated between min and max by the shader)
+        struct VertexData {
+            Vector2 position;
+            Float scalar;
+        };
+
+        const VertexData vertices[]{
+            {{0.0f, -0.5f}, Float(min)},
+            {{0.5f, -0.5f}, Float(min)},
+            {{0.5f, 4.0f}, Float(max)},
+            {{0.0f, 4.0f}, Float(max)}};
 
         // Object and drawable feature
         auto it = _drawables2D.insert(std::make_pair(new objects::ObjectHandle2D(&_scene2D, _drawables2D), nullptr));
+        it.first->first->setRedrawFlag(&_changed);
 
         // Add drawable
         if (it.second) {
             // Create drawable
-            it.first->second = Containers::pointer<drawables::ColorDrawable2D>(*it.first->first, _color2D, *_shadersManager.get<GL::AbstractShaderProgram, Shaders::VertexColorGL2D>("color2D"));
+            auto drawable = Containers::pointer<drawables::ScalarDrawable2D>(*it.first->first, _scalar2D, *_shadersManager.get<GL::AbstractShaderProgram, shaders::ScalarColorGL2D>("scalar2D"));
+            drawable->setColormap(colormapTexture(colorset)).setRange(min, max);
 
-            // Set drawable mesh
-            it.first->second->setMesh(mesh);
+            // Mesh
+            GL::Mesh mesh;
+            mesh.setPrimitive(MeshPrimitive::TriangleFan)
+                .setCount(Containers::arraySize(vertices))
+                .addVertexBuffer(GL::Buffer{vertices}, 0,
+                    shaders::ScalarColorGL2D::Position{},
+                    shaders::ScalarColorGL2D::Scalar{});
+
+            // Set drawable mesh (no bounds, 2D drawables are never culled)
+            drawable->setMesh(mesh);
+
+            it.first->second = std::move(drawable);
         }
 
         return *it.first->first;
     }
 
-    void Graphics::drawEvent()
+    GL::Texture2D& Graphics::colormapTexture(const std::string& colorset)
+    {
+        auto it = _colormaps.find(colorset);
+
+        if (it == _colormaps.end()) {
+            const Containers::ArrayView<const Color4ub> map = colormap(colorset).srgb();
+
+            GL::Texture2D texture;
+            texture.setMinificationFilter(SamplerFilter::Linear)
+                .setMagnificationFilter(SamplerFilter::Linear)
+                .setWrapping(SamplerWrapping::ClampToEdge)
+                .setStorage(1, GL::TextureFormat::SRGB8Alpha8, {Int(map.size()), 1})
+                .setSubImage(0, {}, ImageView2D{PixelFormat::RGBA8Srgb, {Int(map.size()), 1}, map});
+
+            it = _colormaps.emplace(colorset, std::move(texture)).first;
+        }
+
+        return it->second;
+    }
+
+    const tools::Colormap& Graphics::colormap(const std::string& colorset)
+    {
+        auto it = _colormapTables.find(colorset);
+
+        // Built-in maps are linearized on first use
+        if (it == _colormapTables.end()) {
+            Containers::StaticArrayView<256, const Vector3ub> map = DebugTools::ColorMap::turbo();
+
+            if (!colorset.compare("magma"))
+                map = DebugTools::ColorMap::magma();
+            else if (!colorset.compare("plasma"))
+                map = DebugTools::ColorMap::plasma();
+            else if (!colorset.compare("inferno"))
+                map = DebugTools::ColorMap::inferno();
+            else if (!colorset.compare("viridis"))
+                map = DebugTools::ColorMap::viridis();
+
+            it = _colormapTables.emplace(colorset, tools::Colormap{map}).first;
+        }
+
+        return it->second;
+    }
+
+    Graphics& Graphics::addColormap(const std::string& name, const Eigen::Ref<const Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor>>& colors)
+    {
+        // Drawables keep using the texture of a map, so it cannot change once uploaded
+        if (_colormaps.find(name) != _colormaps.end()) {
+            Warning{} << "Colormap" << name.c_str() << "already in use, not replaced";
+            return *this;
+        }
+
+        if (colors.rows() < 2) {
+            Warning{} << "Colormap" << name.c_str() << "needs at least two entries";
+            return *this;
+        }
+
+        _colormapTables[name] = tools::Colormap{colors};
+
+        return *this;
+    }
+
+    Resource<GL::Texture2D> Graphics::addTexture(const std::string& name, GL::Texture2D&& texture)
+    {
+        // Referenced before being set, otherwise the reference counted data is released right away
+        const std::string key = "texture/" + name;
+        Resource<GL::Texture2D> resource = _resourcesManager.get<GL::Texture2D>(key);
+
+        if (resource)
+            Warning{} << "Texture" << name.c_str() << "already in use, not replaced";
+        else
+            _resourcesManager.set(key, new GL::Texture2D{std::move(texture)}, ResourceDataState::Final, ResourcePolicy::ReferenceCounted);
+
+        return resource;
+    }
+
+    Graphics& Graphics::setProfiling(const bool& enable)
+    {
+        _profiler.setEnabled(enable);
+        return *this;
+    }
+
+    bool Graphics::snapshot(const std::string& file)
+    {
+        _profiler.beginFrame();
+
+        processCommands();
+#ifdef GRAPHICSLIB_HEADLESS
+        finishImports();
+#endif
+        render();
+
+        _profiler.endFrame();
+
+        return DebugTools::screenshot(_converterManager, target(), file);
+    }
+
+    Graphics& Graphics::record(const std::string& output, const bool& pipe)
     {
-        GL::defaultFramebuffer.clear(GL::FramebufferClear::Color | GL::FramebufferClear::Depth);
+        _recorder.reset(new tools::Recorder(output, pipe));
+#ifndef GRAPHICSLIB_HEADLESS
+        redraw();
+#endif
+        return *this;
+    }
+
+    Graphics& Graphics::stopRecording()
+    {
+        _recorder = nullptr;
+        return *this;
+    }
+
+#ifdef GRAPHICSLIB_HEADLESS
+    int Graphics::exec()
+    {
+        _profiler.beginFrame();
+
+        processCommands();
+        finishImports();
+        render();
+
+        _profiler.endFrame();
+
+        return 0;
+    }
+#endif
+
+    void Graphics::finishImports()
+    {
+        for (auto& job : _imports)
+            if (job->loaded.valid())
+                job->loaded.wait();
+
+        while (!_imports.empty())
+            processImports();
+    }
+
+    GL::AbstractFramebuffer& Graphics::target()
+    {
+#ifdef GRAPHICSLIB_HEADLESS
+        return _framebuffer;
+#else
+        return GL::defaultFramebuffer;
+#endif
+    }
+
+    void Graphics::render()
+    {
+#ifdef GRAPHICSLIB_HEADLESS
+        _framebuffer.bind();
+#endif
+
+        tools::Profiler::Section profile = _profiler.section("render", true);
 
-        if (!_phong3D.isEmpty())
-            _cameraTemp3D->draw(_phong3D);
+        target().clear(GL::FramebufferClear::Color | GL::FramebufferClear::Depth);
+
+        // Imported parts (potentially thousands) are sorted by state
+        if (!_phong3D.isEmpty()) {
+            tools::Profiler::Section pass = _profiler.section("phong3D", true);
+            _renderQueue ? _cameraTemp3D->drawQueued(_phong3D, _phongQueue.get()) : _cameraTemp3D->draw(_phong3D);
+        }
 
-        if (!_color3D.isEmpty())
+        if (!_color3D.isEmpty()) {
+            tools::Profiler::Section pass = _profiler.section("color3D", true);
             _cameraTemp3D->draw(_color3D);
+        }
+
+        if (!_texture3D.isEmpty()) {
+            tools::Profiler::Section pass = _profiler.section("texture3D", true);
+            _renderQueue ? _cameraTemp3D->drawQueued(_texture3D, _textureQueue.get()) : _cameraTemp3D->draw(_texture3D);
+        }
 
-        if (!_texture3D.isEmpty())
-            _cameraTemp3D->draw(_texture3D);
+        if (!_instanced3D.isEmpty()) {
+            tools::Profiler::Section pass = _profiler.section("instanced3D", true);
+            _cameraTemp3D->draw(_instanced3D);
+        }
+
+        if (!_scalar3D.isEmpty()) {
+            tools::Profiler::Section pass = _profiler.section("scalar3D", true);
+            _cameraTemp3D->draw(_scalar3D);
+        }
 
-        if (!_color2D.isEmpty())
+        if (!_flat3D.isEmpty()) {
+            tools::Profiler::Section pass = _profiler.section("flat3D", true);
+            _cameraTemp3D->draw(_flat3D);
+        }
+
+        if (!_color2D.isEmpty()) {
+            tools::Profiler::Section pass = _profiler.section("color2D", true);
             _cameraTemp2D->draw(_color2D);
+        }
+
+        if (!_scalar2D.isEmpty()) {
+            tools::Profiler::Section pass = _profiler.section("scalar2D", true);
+            _cameraTemp2D->draw(_scalar2D);
+        }
 
-        swapBuffers();
+        // Readback collected a few frames later by the recorder (no stall)
+        if (_recorder) {
+            tools::Profiler::Section pass = _profiler.section("capture", true);
+            _recorder->capture(target());
+        }
+    }
 
-        redraw();
+    void Graphics::cleanObjects()
+    {
+        // Cleaning an object cleans its dirty parents as well (objects without drawables below them are never drawn)
+        for (auto& object : _drawables3D)
+            if (object.first->isDirty())
+                object.first->setClean();
+
+        for (auto& object : _drawables2D)
+            if (object.first->isDirty())
+                object.first->setClean();
+    }
+
+#ifndef GRAPHICSLIB_HEADLESS
+    void Graphics::tickEvent()
+    {
+        if (_changed)
+            redraw();
     }
 
-    Containers::StaticArrayView<256, const Vector3ub> Graphics::colormap(const std::string& map) const
+    void Graphics::drawEvent()
     {
-        if (!map.compare("sphere"))
-            return DebugTools::ColorMap::turbo();
-        else if (!map.compare("capsule"))
-            return DebugTools::ColorMap::magma();
-        else if (!map.compare("cone"))
-            return DebugTools::ColorMap::plasma();
-        else if (!map.compare("cylinder"))
-            return DebugTools::ColorMap::inferno();
-        else if (!map.compare("cylinder"))
-            return DebugTools::ColorMap::viridis();
+        // Changes made from now on need a new frame
+        _changed = false;
+        cleanObjects();
+
+        _profiler.beginFrame();
+
+        // Updates posted from other threads
+        if (!_commands.empty()) {
+            tools::Profiler::Section profile = _profiler.section("commands");
+            processCommands();
+        }
+
+        // Progressive uploads of asynchronous imports
+        if (!_imports.empty()) {
+            tools::Profiler::Section profile = _profiler.section("imports", true);
+            processImports();
+        }
+
+        render();
+
+        {
+            tools::Profiler::Section profile = _profiler.section("swap");
+            swapBuffers();
+        }
+
+        _profiler.endFrame();
+
+        // Keep drawing only while something is animating, loading or being recorded
+        if (_continuous || !_imports.empty() || _recorder)
+            redraw();
+    }
+#endif
+
+    Range3D Graphics::primitiveBounds(const std::string& primitive) const
+    {
+        // Capsule: unit radius + 0.5 half-length along Y, all the other primitives fit the [-1, 1] cube
+        if (!primitive.compare("capsule"))
+            return {{-1.0f, -1.5f, -1.0f}, {1.0f, 1.5f, 1.0f}};
+
+        return {Vector3{-1.0f}, Vector3{1.0f}};
+    }
+
+    std::string Graphics::textureKey(const std::string& file, const UnsignedInt& id) const
+    {
+        return file + "/texture/" + std::to_string(id);
+    }
+
+    std::string Graphics::materialKey(const std::string& file, const UnsignedInt& id) const
+    {
+        return file + "/material/" + std::to_string(id);
+    }
+
+    std::string Graphics::primitiveKey(const std::string& primitive) const
+    {
+        if (!primitive.compare("sphere"))
+            return "sphere/3";
+        else if (!primitive.compare("capsule"))
+            return "capsule/10/10/30/0.5";
+        else if (!primitive.compare("cone"))
+            return "cone/10/30/1";
+        else if (!primitive.compare("cylinder"))
+            return "cylinder/10/30/1";
         else
-            return DebugTools::ColorMap::turbo();
+            return "cube";
     }
 
+    Resource<GL::Mesh> Graphics::primitiveMesh(const std::string& primitive)
+    {
+        const std::string key = primitiveKey(primitive);
+
+        // Already generated
+        Resource<GL::Mesh> cached = _resourcesManager.get<GL::Mesh>(key);
+        if (cached)
+            return cached;
+
+        // Default mesh cube
+        Trade::MeshData mesh_data = Primitives::cubeSolid();
+
+        if (!primitive.compare("sphere"))
+            mesh_data = Primitives::icosphereSolid(3);
+        else if (!primitive.compare("capsule"))
+            mesh_data = Primitives::capsule3DSolid(10, 10, 30, 0.5);
+        else if (!primitive.compare("cone"))
+            mesh_data = Primitives::coneSolid(10, 30, 1, Primitives::ConeFlag::CapEnd);
+        else if (!primitive.compare("cylinder"))
+            mesh_data = Primitives::cylinderSolid(10, 30, 1, Primitives::CylinderFlag::CapEnds);
+
+        // Vertices
+        GL::Buffer vertices;
+        vertices.setData(MeshTools::interleave(mesh_data.positions3DAsArray(),
+            mesh_data.normalsAsArray()));
+
+        // Indices
+        std::pair<Containers::Array<char>, MeshIndexType> compressed = MeshTools::compressIndices(mesh_data.indicesAsArray());
+        GL::Buffer indices;
+        indices.setData(compressed.first);
+
+        // Buffers are kept in the manager so that instanced meshes can reference them too
+        _resourcesManager
+            .set<GL::Buffer>(key + "/vertices", new GL::Buffer{std::move(vertices)})
+            .set<GL::Buffer>(key + "/indices", new GL::Buffer{std::move(indices)});
+
+        // Mesh
+        GL::Mesh mesh;
+        mesh
+            .setPrimitive(mesh_data.primitive())
+            .setCount(mesh_data.indexCount())
+            .addVertexBuffer(*_resourcesManager.get<GL::Buffer>(key + "/vertices"), 0, Shaders::PhongGL::Position{},
+                Shaders::PhongGL::Normal{})
+            .setIndexBuffer(*_resourcesManager.get<GL::Buffer>(key + "/indices"), 0, compressed.second);
+
+        _resourcesManager.set<GL::Mesh>(key, new GL::Mesh{std::move(mesh)});
+
+        return _resourcesManager.get<GL::Mesh>(key);
+    }
+
+#ifndef GRAPHICSLIB_HEADLESS
     void Graphics::viewportEvent(ViewportEvent& event)
     {
         GL::defaultFramebuffer.setViewport({{}, event.framebufferSize()});
@@ -582,10 +1526,10 @@ namespace graphics_lib {
 
     void Graphics::mouseMoveEvent(MouseMoveEvent& event)
     {
-        if (event.buttons() == MouseMoveEvent::Button::Left)
+        if (event.buttons() == MouseMoveEvent::Button::Left) {
             _cameraTemp3D->move(event.relativePosition());
-
-        redraw();
+            redraw();
+        }
     }
 
     Vector3 Graphics::positionOnSphere(const Vector2i& position) const
@@ -596,4 +1540,5 @@ namespace graphics_lib {
 
         return (result * Vector3::yScale(-1.0f)).normalized();
     }
+#endif
 } // namespace graphics_lib
\ No newline at end of file
@@ -26,17 +26,31 @@
 #define GRAPHICSLIB_GRAPHICS_HPP
 
 /* STD LIBRARY */
+#include <atomic>
+#include <functional>
+#include <future>
 #include <iostream>
+#include <limits>
 #include <map>
 #include <memory>
 #include <type_traits>
 #include <unordered_map>
+#include <vector>
 
 /* MAGNUM MAIN */
 #include <Magnum/Magnum.h>
 
-/* WINDOW APPLICATION */
+/* APPLICATION (window or offscreen) */
+#ifdef GRAPHICSLIB_HEADLESS
+#include <Magnum/GL/Framebuffer.h>
+#include <Magnum/GL/Renderbuffer.h>
+#include <Magnum/Platform/WindowlessEglApplication.h>
+#else
 #include <Magnum/Platform/Sdl2Application.h>
+#endif
+
+/* SNAPSHOTS */
+#include <Magnum/Trade/AbstractImageConverter.h>
 
 /* ARGUMENT PARSER */
 #include <Corrade/Utility/Arguments.h>
@@ -49,21 +63,34 @@
 #include <Magnum/SceneGraph/Scene.h>
 #include <Magnum/SceneGraph/SceneGraph.h>
 
-/* SHADERS MANAGER */
+/* RESOURCES MANAGER */
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/Mesh.h>
 #include <Magnum/ResourceManager.h>
 
 /* ABSTRACT IMPORTER & MANAGER */
 #include <Corrade/PluginManager/Manager.h>
 #include <Magnum/Trade/AbstractImporter.h>
 
+/* IMPORTED DATA */
+#include <Magnum/GL/Texture.h>
+#include <Magnum/Trade/ImageData.h>
+#include <Magnum/Trade/MeshData.h>
+#include <Magnum/Trade/PhongMaterialData.h>
+#include <Magnum/Trade/TextureData.h>
+
 /* INTEGRATIONS */
 #include <Magnum/EigenIntegration/Integration.h>
 
 /* CONTAINERS */
 #include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pair.h>
 #include <Corrade/Containers/Pointer.h>
 
+/* MEMORY MAPPED FILES */
+#include <Corrade/Utility/Path.h>
+
 using namespace Corrade;
 using namespace Magnum;
 using namespace Math::Literals;
@@ -75,12 +102,26 @@ using namespace Math::Literals;
 /* OBJECTS */
 #include "graphics_lib/objects/ObjectHandle.hpp"
 #include "graphics_lib/objects/Objects.h"
+#include "graphics_lib/objects/PoseBatch.hpp"
 
 /* HELPERS */
+#include "graphics_lib/tools/Colormap.hpp"
+#include "graphics_lib/tools/CommandQueue.hpp"
+#include "graphics_lib/tools/MeshSimplifier.hpp"
+#include "graphics_lib/tools/Profiler.hpp"
+#include "graphics_lib/tools/Recorder.hpp"
 #include "graphics_lib/tools/helper.hpp"
+#include "graphics_lib/tools/quantize.hpp"
 
 namespace graphics_lib {
-    class Graphics : public Platform::Application {
+#ifdef GRAPHICSLIB_HEADLESS
+    // Offscreen rendering (EGL, works without display and with Mesa software rasterizer)
+    using GraphicsApplication = Platform::WindowlessEglApplication;
+#else
+    using GraphicsApplication = Platform::Application;
+#endif
+
+    class Graphics : public GraphicsApplication {
     public:
         explicit Graphics(const Arguments& arguments);
         ~Graphics();
@@ -104,6 +145,27 @@ namespace graphics_lib {
         // Set window background
         Graphics& setBackground(const std::string& colorname);
 
+        // Set window (or offscreen framebuffer) size
+        Graphics& setSize(const Vector2i& size);
+
+        // Redraw continuously (animations) instead of only when the scene changed
+        Graphics& setContinuous(const bool& continuous);
+
+        // Draw Phong/textured objects through a state-sorted render queue (enabled by default)
+        // Per-draw transformations and materials go through uniform buffers when the context supports them
+        Graphics& setRenderQueue(const bool& enable);
+
+        // Cache imported files in binary form (reloaded by memory mapping, empty to disable)
+        Graphics& setCacheDirectory(const std::string& directory);
+
+        // Simplified versions generated for imported meshes and surfaces created from now on (0 disables)
+        // The version drawn is chosen from its projected error (needs the MeshOptimizerSceneConverter plugin)
+        Graphics& setDetailLevels(const size_t& levels);
+
+        // Store positions of trajectories, surfaces and imported meshes created from now on as 16-bit values inside their bounding box
+        // (normals, texture coordinates and colors of imported meshes in 8/16 bits); lower memory and bandwidth for a small precision loss
+        Graphics& setQuantization(const bool& enable);
+
         /* ================================================== */
 
         /* DRAWINGS ======================================== */
@@ -112,32 +174,228 @@ namespace graphics_lib {
         objects::ObjectHandle3D& frame();
 
         // Draw a 3D trajectory
-        objects::ObjectHandle3D& trajectory(const Eigen::Matrix<double, Eigen::Dynamic, 3>& trajectory, const std::string& color_to_set = "green");
+        objects::ObjectHandle3D& trajectory(const Eigen::Ref<const Eigen::Matrix<double, Eigen::Dynamic, 3>>& trajectory, const std::string& color_to_set = "green");
+
+        // Draw a 3D trajectory from float rows (contiguous rows uploaded without intermediate copies)
+        objects::ObjectHandle3D& trajectory(const Eigen::Ref<const Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor>>& trajectory, const std::string& color_to_set = "green");
+
+        // Draw a 3D trajectory that can be extended over time (only the last "capacity" points are kept)
+        objects::ObjectHandle3D& stream(const size_t& capacity, const std::string& color_to_set = "green");
 
         // Draw a 3D primitive shape
         objects::ObjectHandle3D& primitive(const std::string& primitive);
 
+        // Draw many copies of a 3D primitive shape (single draw call, per-instance position and color)
+        objects::ObjectHandle3D& primitives(const std::string& primitive, const Eigen::Matrix<double, Eigen::Dynamic, 3>& positions, const Eigen::Matrix<double, Eigen::Dynamic, 3>& colors = Eigen::Matrix<double, Eigen::Dynamic, 3>(), const double& scale = 1);
+
+        // Draw many instances of a primitive with full poses, one row per instance: 4x4 row-major transformation (16 columns) or [x y z qx qy qz qw] (7 columns)
+        objects::ObjectHandle3D& primitivesFromPoses(const std::string& primitive, const Eigen::Ref<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>& poses, const Eigen::Matrix<double, Eigen::Dynamic, 3>& colors = Eigen::Matrix<double, Eigen::Dynamic, 3>());
+
         // Draw a 2D (gradient colored) surface
-        objects::ObjectHandle3D& surface(const Eigen::MatrixXd& vertices, const Eigen::VectorXd& fun, const Eigen::MatrixXd& indices, const double& min = -1, const double& max = 1, const std::string& colormap = "turbo");
+        objects::ObjectHandle3D& surface(const Eigen::Ref<const Eigen::MatrixXd>& vertices, const Eigen::Ref<const Eigen::VectorXd>& fun, const Eigen::Ref<const Eigen::MatrixXd>& indices, const double& min = -1, const double& max = 1, const std::string& colormap = "turbo");
+
+        // Draw a 2D (gradient colored) surface from float vertices/scalars and integer triangles (contiguous rows uploaded without intermediate copies)
+        objects::ObjectHandle3D& surface(const Eigen::Ref<const Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor>>& vertices, const Eigen::Ref<const Eigen::VectorXf>& fun,
+            const Eigen::Ref<const Eigen::Matrix<int, Eigen::Dynamic, 3, Eigen::RowMajor>>& indices, const double& min = -1, const double& max = 1, const std::string& colormap = "turbo");
+
+        // Draw a point cloud (colored by the scalars or by the elevation if no scalars are given)
+        objects::ObjectHandle3D& pointCloud(const Eigen::Matrix<double, Eigen::Dynamic, 3>& positions, const Eigen::VectorXd& scalars = Eigen::VectorXd(), const std::string& colormap = "turbo");
 
         // Draw from file (return object parent of all the objects inside the file)
         objects::ObjectHandle3D& import(const std::string& file, const std::string& importer = "");
 
+        // Draw from file without blocking (file parsed on a worker thread, GPU uploads spread across frames)
+        // The returned object is filled progressively; progress is reported in [0, 1]
+        objects::ObjectHandle3D& importAsync(const std::string& file, const std::string& importer = "",
+            std::function<void(objects::ObjectHandle3D&, const float&)> progress = {}, std::function<void(objects::ObjectHandle3D&)> completion = {});
+
+        // Bind objects to set all their poses at once from contiguous arrays (one row per object)
+        objects::PoseBatch bind(const std::vector<objects::ObjectHandle3D*>& handles) const;
+
         // Draw a 2Dcolorbar (attached to the window)
         objects::ObjectHandle2D& colorbar(const double& min, const double& max, const std::string& colormap = "turbo");
 
+        // Get colormap texture (created once per colormap and shared by all the scalar drawables)
+        GL::Texture2D& colormapTexture(const std::string& colormap);
+
+        // Get colormap lookup table (built-in maps: turbo, magma, plasma, inferno, viridis; unknown names fall back to turbo)
+        // Use it to map scalars to colors on the CPU, e.g. colormap("viridis").map(values, min, max, colors)
+        const tools::Colormap& colormap(const std::string& colormap);
+
+        // Register a colormap from sRGB entries in [0, 1] (one row per entry, at least two), usable by name afterwards
+        Graphics& addColormap(const std::string& name, const Eigen::Ref<const Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor>>& colors);
+
+        // Register a texture shared by many drawables (e.g. ObjectHandle::setTexture() on a subtree), released with the last one using it
+        Resource<GL::Texture2D> addTexture(const std::string& name, GL::Texture2D&& texture);
+
+        /* ================================================== */
+
+        /* THREAD-SAFE UPDATES ======================================== */
+
+        // Set the pose of an object from any thread (applied at the start of the next frame, only the newest pose is kept)
+        Graphics& post(objects::ObjectHandle3D& object, const Matrix4& transformation);
+
+        // Run a call from any thread on the rendering thread at the start of the next frame (object creation, data updates)
+        Graphics& post(std::function<void(Graphics&)> call);
+
+        /* ================================================== */
+
+        /* OUTPUT ======================================== */
+
+        // Render the current scene and save it to file (format deduced from the extension)
+        bool snapshot(const std::string& file);
+
+        // Record every rendered frame (image sequence pattern or encoder command when piped, see tools::Recorder)
+        // Rendering is continuous while recording
+        Graphics& record(const std::string& output, const bool& pipe = false);
+
+        // Stop recording (waits for the frames still being written)
+        Graphics& stopRecording();
+
+        // Time draw passes (CPU and GPU) and build calls (CPU), see profiler() for the history and trace export
+        Graphics& setProfiling(const bool& enable);
+
+        // Profiler (e.g. profiler().save("trace.json") to inspect the last frames in chrome://tracing)
+        tools::Profiler& profiler() { return _profiler; }
+
+#ifdef GRAPHICSLIB_HEADLESS
+        // Finish pending imports and render one frame (images are produced via snapshot)
+        int exec() override;
+#endif
+
         /* ================================================== */
 
     protected:
+        // CPU side data loaded from file (no GL calls, can be prepared on any thread)
+        struct ImportData {
+            Containers::Array<Containers::Optional<Trade::TextureData>> textures;
+            Containers::Array<Containers::Optional<Trade::ImageData2D>> images; // one per texture
+            Containers::Array<Containers::Optional<Trade::PhongMaterialData>> materials;
+            Containers::Array<Containers::Optional<Trade::MeshData>> meshes;
+
+            // Scene hierarchy
+            bool hasScene = false;
+            std::size_t mappingBound = 0;
+            Containers::Array<Containers::Pair<UnsignedInt, Int>> parents;
+            Containers::Array<Containers::Pair<UnsignedInt, Containers::Pair<UnsignedInt, Int>>> meshesMaterials;
+            Containers::Array<Containers::Pair<UnsignedInt, Matrix4>> transformations;
+
+            // Cache file the meshes are pointing to (when loaded from cache)
+            Containers::Optional<Containers::Array<const char, Utility::Path::MapDeleter>> mapping;
+
+            // Simplified versions of each mesh (empty if disabled)
+            Containers::Array<Containers::Array<tools::MeshLevel>> levels;
+        };
+
+        // Import in progress (loaded data, uploaded GPU resources and next upload step)
+        struct ImportJob {
+            objects::ObjectHandle3D* handle = nullptr;
+            // Plugin manager of the job only (managers are not thread-safe, the worker may load format plugins through it)
+            Containers::Pointer<PluginManager::Manager<Trade::AbstractImporter>> manager;
+            Containers::Pointer<Trade::AbstractImporter> importer;
+            std::string file;
+            ImportData data;
+            Containers::Array<Resource<GL::Texture2D>> textures; // shared through the resources manager
+            Containers::Array<Containers::Optional<GL::Mesh>> meshes;
+            Containers::Array<Containers::Optional<Range3D>> bounds; // one per mesh
+            Containers::Array<Containers::Array<drawables::DetailLevel>> levels; // one per mesh
+            Containers::Array<Containers::Optional<Matrix4>> dequantizations; // one per mesh (quantized meshes only)
+            bool quantization = false;
+            size_t step = 0;
+            std::function<void(objects::ObjectHandle3D&, const float&)> progress;
+            std::function<void(objects::ObjectHandle3D&)> completion;
+
+            // Declared last so that it is destroyed first (waits for the worker still using the data above)
+            std::future<bool> loaded;
+        };
+
+        // Maximum number of textures/meshes uploaded per frame by asynchronous imports
+        static constexpr size_t ImportUploadsPerFrame = 8;
+
+        // Parse file and prepare CPU side data (images of the textures for which "resident" returns true are not decoded)
+        bool load(Trade::AbstractImporter& importer, const std::string& file, ImportData& data, const std::function<bool(UnsignedInt)>& resident = {}) const;
+
+        // Cache file of an imported file (named after its content, empty if the file cannot be read)
+        std::string cacheFile(const std::string& file) const;
+
+        // Write/read the CPU side data of an import to/from a binary cache file
+        bool saveCache(const std::string& file, const ImportData& data) const;
+        bool loadCache(const std::string& file, ImportData& data) const;
+
+        // Update posted from another thread (pose when "object" is set, call otherwise)
+        struct Command {
+            objects::ObjectHandle3D* object = nullptr;
+            Matrix4 transformation;
+            std::function<void(Graphics&)> call;
+        };
+
+        // Apply the updates posted since the last frame
+        void processCommands();
+
+        // Generate the simplified versions of the loaded meshes (in parallel)
+        void simplify(ImportData& data, const size_t& levels) const;
+
+        // Mesh with quantized attributes (positions inside "range", others dropped if not supported)
+        Trade::MeshData quantize(const Trade::MeshData& mesh, const Range3D& range) const;
+
+        // Append the simplified versions to the index buffer of a mesh ("indices" is the full triangle list)
+        Containers::Array<drawables::DetailLevel> addDetailLevels(GL::Mesh& mesh, Containers::ArrayView<const UnsignedInt> indices, Containers::ArrayView<const tools::MeshLevel> levels) const;
+
+        // Upload up to "budget" textures/meshes (the last step creates objects and drawables); true when done
+        bool upload(ImportJob& job, size_t budget);
+
+        // Create objects and drawables of an uploaded import
+        void addImported(ImportJob& job);
+
+        // Advance asynchronous imports
+        void processImports();
+
+        // Render all the drawables to the current target
+        void render();
+
+        // Clean the objects moved since the last frame (their next change raises the redraw flag again)
+        void cleanObjects();
+
+        // Wait for asynchronous imports and upload them entirely
+        void finishImports();
+
+        // Render target (default framebuffer or offscreen framebuffer)
+        GL::AbstractFramebuffer& target();
+
+#ifndef GRAPHICSLIB_HEADLESS
         // Draw
         void drawEvent() override;
 
-        // Colormap
-        Containers::StaticArrayView<256, const Vector3ub> colormap(const std::string& map) const;
+        // Schedule a frame if something changed since the last one
+        void tickEvent() override;
+#endif
+
+        // Texture/material registry keys (file + importer ID)
+        std::string textureKey(const std::string& file, const UnsignedInt& id) const;
+        std::string materialKey(const std::string& file, const UnsignedInt& id) const;
+
+        // Primitive cache key (kind + tessellation parameters)
+        std::string primitiveKey(const std::string& primitive) const;
+
+        // Primitive bounding box
+        Range3D primitiveBounds(const std::string& primitive) const;
+
+        // Primitive mesh (indexed position + normal), generated once and shared
+        Resource<GL::Mesh> primitiveMesh(const std::string& primitive);
+
+        // Object and instanced drawable sharing the mesh of a primitive (instances not set)
+        std::pair<objects::ObjectHandle3D*, drawables::InstancedDrawable3D*> instanced(const std::string& primitive);
 
         // Handle multiple shaders
         ResourceManager<GL::AbstractShaderProgram> _shadersManager;
 
+        // Shared resources (cached primitive meshes and their buffers, imported textures and materials)
+        ResourceManager<GL::Buffer, GL::Mesh, GL::Texture2D, Trade::PhongMaterialData> _resourcesManager;
+
+        // Redraw flag (raised by objects and cameras, declared before the scenes to outlive them)
+        std::atomic<bool> _changed{true};
+        bool _continuous = false;
+
         // Scene
         SceneGraph::Scene<SceneGraph::MatrixTransformation2D> _scene2D;
         SceneGraph::Scene<SceneGraph::MatrixTransformation3D> _scene3D;
@@ -154,13 +412,53 @@ namespace graphics_lib {
         std::unordered_map<objects::ObjectHandle3D*, Containers::Pointer<drawables::AbstractDrawable3D>> _drawables3D;
 
         // Drawables (it would be better to have in an optional container)
-        SceneGraph::DrawableGroup2D _color2D;
-        SceneGraph::DrawableGroup3D _phong3D, _texture3D, _color3D;
+        SceneGraph::DrawableGroup2D _color2D, _scalar2D;
+        SceneGraph::DrawableGroup3D _phong3D, _texture3D, _color3D, _scalar3D, _flat3D, _instanced3D;
+
+        // Colormap lookup tables and textures
+        std::unordered_map<std::string, tools::Colormap> _colormapTables;
+        std::unordered_map<std::string, GL::Texture2D> _colormaps;
 
         // Manager (to set importer) & importer
         PluginManager::Manager<Trade::AbstractImporter> _manager;
         Containers::Pointer<Trade::AbstractImporter> _importer;
 
+        // Asynchronous imports
+        std::vector<Containers::Pointer<ImportJob>> _imports;
+
+        // Image converters (snapshots)
+        PluginManager::Manager<Trade::AbstractImageConverter> _converterManager;
+
+        // Updates posted from other threads (bounded, posting waits while it is full) and newest pose per object while draining
+        tools::CommandQueue<Command> _commands;
+        std::unordered_map<objects::ObjectHandle3D*, Matrix4> _posted;
+
+        // Instrumentation (disabled by default)
+        tools::Profiler _profiler;
+
+        // Frame recording
+        Containers::Pointer<tools::Recorder> _recorder;
+
+#ifdef GRAPHICSLIB_HEADLESS
+        // Offscreen render target
+        GL::Framebuffer _framebuffer{NoCreate};
+        GL::Renderbuffer _colorbuffer{NoCreate}, _depthbuffer{NoCreate};
+#endif
+
+        // Render queue mode and uniform buffer queues of the phong/texture groups (null if uniform buffers are not supported)
+        bool _renderQueue = true;
+        Containers::Pointer<drawables::UniformQueue> _phongQueue, _textureQueue;
+
+        // Imports cache directory (disabled if empty)
+        std::string _cacheDirectory;
+
+        // Simplified versions per mesh
+        size_t _detailLevels = 0;
+
+        // Compact vertex formats
+        bool _quantization = false;
+
+#ifndef GRAPHICSLIB_HEADLESS
         // Mouse interaction
         Vector3 _previousPosition;
 
@@ -170,6 +468,7 @@ namespace graphics_lib {
         void mouseMoveEvent(MouseMoveEvent& event) override;
         void mouseScrollEvent(MouseScrollEvent& event) override;
         Vector3 positionOnSphere(const Vector2i& position) const;
+#endif
     };
 } // namespace graphics_lib
 
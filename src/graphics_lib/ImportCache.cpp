@@ -0,0 +1,557 @@
+/*
+    This file is part of graphics-lib.
+
+    Copyright (c) 2020, 2021, 2022 Bernardo Fichera <bernardo.fichera@gmail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "graphics_lib/Graphics.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+#include <Corrade/Containers/StringStl.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/Path.h>
+
+#include <Magnum/Trade/MaterialData.h>
+
+namespace graphics_lib {
+    namespace {
+        // Bump every time the layout below changes (old cache files are simply ignored)
+        constexpr UnsignedInt CacheVersion = 2;
+        constexpr UnsignedLong CacheMagic = 0x0045484341434c47ull; // "GLCACHE"
+
+        // Blobs are aligned so that vertex/index data can be used straight from the mapped file
+        constexpr std::size_t CacheAlignment = 16;
+
+        constexpr UnsignedLong HashBasis = 14695981039346656037ull;
+
+        // FNV-1a (changes of the source file, integrity of the cache layout)
+        UnsignedLong hashBytes(UnsignedLong hash, Containers::ArrayView<const char> data)
+        {
+            for (const char c : data)
+                hash = (hash ^ UnsignedByte(c)) * 1099511628211ull;
+            return hash;
+        }
+
+        UnsignedLong hashContent(Containers::ArrayView<const char> data) { return hashBytes(HashBasis, data); }
+
+        // Values are hashed as they are written, blobs are not (only their size), see finish()
+        class CacheWriter {
+        public:
+            template <typename T>
+            CacheWriter& write(const T& value)
+            {
+                static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable types can be cached");
+                const Containers::ArrayView<const char> bytes{reinterpret_cast<const char*>(&value), sizeof(T)};
+                _hash = hashBytes(_hash, bytes);
+                arrayAppend(_data, bytes);
+                return *this;
+            }
+
+            // Hash of all the values written so far (a corrupted layout is detected before anything is built from it)
+            CacheWriter& finish()
+            {
+                const UnsignedLong hash = _hash;
+                return write(hash);
+            }
+
+            CacheWriter& writeBlob(Containers::ArrayView<const char> blob)
+            {
+                write(UnsignedLong(blob.size()));
+                Containers::ArrayView<char> padding = arrayAppend(_data, Containers::NoInit, (CacheAlignment - _data.size() % CacheAlignment) % CacheAlignment);
+                std::memset(padding.data(), 0, padding.size());
+                arrayAppend(_data, blob);
+                return *this;
+            }
+
+            Containers::ArrayView<const char> data() const { return _data; }
+
+        private:
+            Containers::Array<char> _data;
+            UnsignedLong _hash = HashBasis;
+        };
+
+        class CacheReader {
+        public:
+            explicit CacheReader(Containers::ArrayView<const char> data) : _data{data}, _position{0}, _valid{true}, _hash{HashBasis} {}
+
+            template <typename T>
+            T read()
+            {
+                T value{};
+                if (!check(sizeof(T)))
+                    return value;
+                std::memcpy(&value, _data.data() + _position, sizeof(T));
+                _hash = hashBytes(_hash, _data.slice(_position, _position + sizeof(T)));
+                _position += sizeof(T);
+                return value;
+            }
+
+            // Number of elements of an array whose elements take at least "size" bytes each (invalid if the file cannot hold them)
+            template <typename T>
+            std::size_t readCount(const std::size_t& size)
+            {
+                const UnsignedLong count = read<T>();
+                if (_valid && count <= (_data.size() - _position) / size)
+                    return std::size_t(count);
+                _valid = false;
+                return 0;
+            }
+
+            // Whether the hash stored by CacheWriter::finish() matches the values read
+            bool finish()
+            {
+                const UnsignedLong hash = _hash;
+                return read<UnsignedLong>() == hash && _valid;
+            }
+
+            Containers::ArrayView<const char> readBlob()
+            {
+                const std::size_t size = read<UnsignedLong>();
+                _position += (CacheAlignment - _position % CacheAlignment) % CacheAlignment;
+                if (!check(size))
+                    return {};
+                Containers::ArrayView<const char> blob = _data.slice(_position, _position + size);
+                _position += size;
+                return blob;
+            }
+
+            bool valid() const { return _valid; }
+
+        private:
+            bool check(std::size_t size)
+            {
+                if (_valid && _position <= _data.size() && size <= _data.size() - _position)
+                    return true;
+                _valid = false;
+                return false;
+            }
+
+            Containers::ArrayView<const char> _data;
+            std::size_t _position;
+            bool _valid;
+            UnsignedLong _hash;
+        };
+
+        // Image read from a cache, copied into Trade::ImageData2D once the whole file has been validated
+        struct CachedImage {
+            bool compressed;
+            CompressedPixelFormat compressedFormat;
+            PixelFormat format;
+            Int alignment;
+            Vector2i size;
+            Containers::ArrayView<const char> pixels;
+        };
+
+        // Pixels cover the whole image (compressed images are only checked for a valid size)
+        bool validImage(const CachedImage& image)
+        {
+            if (image.size.x() < 0 || image.size.y() < 0)
+                return false;
+
+            if (image.compressed)
+                return !isCompressedPixelFormatImplementationSpecific(image.compressedFormat);
+
+            if (isPixelFormatImplementationSpecific(image.format) || !UnsignedInt(image.format) || image.format > PixelFormat::Depth32FStencil8UI)
+                return false;
+
+            if (image.alignment != 1 && image.alignment != 2 && image.alignment != 4 && image.alignment != 8)
+                return false;
+
+            // Rows are padded to the alignment
+            const std::size_t row = (std::size_t(image.size.x()) * pixelFormatSize(image.format) + image.alignment - 1) / image.alignment * image.alignment;
+            return !row || std::size_t(image.size.y()) <= image.pixels.size() / row;
+        }
+
+        // Mesh layout read from a cache, turned into Trade::MeshData once the whole file has been validated
+        struct CachedAttribute {
+            Trade::MeshAttribute name;
+            VertexFormat format;
+            UnsignedLong offset;
+            Long stride;
+            UnsignedShort arraySize;
+        };
+
+        struct CachedMesh {
+            MeshPrimitive primitive;
+            UnsignedInt vertexCount;
+            bool indexed;
+            MeshIndexType indexType;
+            UnsignedLong indexOffset;
+            UnsignedInt indexCount;
+            Containers::ArrayView<const char> indexData;
+            Containers::Array<CachedAttribute> attributes;
+            Containers::ArrayView<const char> vertexData;
+        };
+
+        // Minimum size of a serialized attribute (name, format, offset, stride, array size)
+        constexpr std::size_t CachedAttributeSize = sizeof(Trade::MeshAttribute) + sizeof(VertexFormat) + sizeof(UnsignedLong) + sizeof(Long) + sizeof(UnsignedShort);
+
+        template <typename T>
+        bool validIndices(Containers::ArrayView<const char> data, const UnsignedInt& vertexCount)
+        {
+            for (std::size_t i = 0; i < data.size(); i += sizeof(T)) {
+                T index;
+                std::memcpy(&index, data.data() + i, sizeof(T));
+                if (index >= vertexCount)
+                    return false;
+            }
+
+            return true;
+        }
+
+        // Indices and attributes within their blobs, indices within the vertices (blob contents are not hashed)
+        bool validMesh(const CachedMesh& mesh)
+        {
+            if (isMeshPrimitiveImplementationSpecific(mesh.primitive) || mesh.primitive < MeshPrimitive::Points || mesh.primitive > MeshPrimitive::Edges)
+                return false;
+
+            if (mesh.indexed) {
+                if (mesh.indexType != MeshIndexType::UnsignedByte && mesh.indexType != MeshIndexType::UnsignedShort && mesh.indexType != MeshIndexType::UnsignedInt)
+                    return false;
+
+                const std::size_t size = meshIndexTypeSize(mesh.indexType);
+                if (mesh.indexOffset > mesh.indexData.size() || mesh.indexCount > (mesh.indexData.size() - mesh.indexOffset) / size)
+                    return false;
+
+                const Containers::ArrayView<const char> indices = mesh.indexData.slice(mesh.indexOffset, mesh.indexOffset + mesh.indexCount * size);
+                if (!(size == 1 ? validIndices<UnsignedByte>(indices, mesh.vertexCount) : size == 2 ? validIndices<UnsignedShort>(indices, mesh.vertexCount) : validIndices<UnsignedInt>(indices, mesh.vertexCount)))
+                    return false;
+            }
+
+            for (const CachedAttribute& attribute : mesh.attributes) {
+                // Conservative format range (a rejected cache only means parsing the source file again)
+                if (isVertexFormatImplementationSpecific(attribute.format) || !UnsignedInt(attribute.format) || attribute.format > VertexFormat::Matrix4x4d || attribute.stride < 0)
+                    return false;
+
+                // offset + (vertexCount - 1)*stride + size <= vertex data size (without overflowing)
+                const std::size_t size = vertexFormatSize(attribute.format) * (attribute.arraySize ? attribute.arraySize : 1);
+                if (attribute.offset > mesh.vertexData.size() || size > mesh.vertexData.size() - attribute.offset)
+                    return false;
+
+                const std::size_t available = mesh.vertexData.size() - attribute.offset - size;
+                if (mesh.vertexCount > 1 && attribute.stride && std::size_t(mesh.vertexCount - 1) > available / std::size_t(attribute.stride))
+                    return false;
+            }
+
+            return true;
+        }
+    } // namespace
+
+    Graphics& Graphics::setCacheDirectory(const std::string& directory)
+    {
+        if (!directory.empty() && !Utility::Path::make(directory))
+            Warning{} << "Cannot create cache directory" << directory.c_str();
+        else
+            _cacheDirectory = directory;
+
+        return *this;
+    }
+
+    std::string Graphics::cacheFile(const std::string& file) const
+    {
+        Containers::Optional<Containers::Array<const char, Utility::Path::MapDeleter>> content = Utility::Path::mapRead(file);
+        if (!content)
+            return {};
+
+        char hash[17];
+        std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(hashContent(*content)));
+
+        // Same file name with different content gets a different cache file
+        return _cacheDirectory + "/" + file.substr(file.find_last_of("/\\") + 1) + "." + hash + ".glcache";
+    }
+
+    bool Graphics::saveCache(const std::string& file, const ImportData& data) const
+    {
+        CacheWriter writer;
+        writer.write(CacheMagic).write(CacheVersion);
+
+        /* Textures (sampler + image) */
+        writer.write(UnsignedInt(data.textures.size()));
+        for (std::size_t i = 0; i != data.textures.size(); ++i) {
+            const bool present = data.textures[i] && data.images[i];
+            writer.write(UnsignedByte(present));
+            if (!present)
+                continue;
+
+            const Trade::TextureData& texture = *data.textures[i];
+            const Trade::ImageData2D& image = *data.images[i];
+
+            writer.write(texture.minificationFilter())
+                .write(texture.magnificationFilter())
+                .write(texture.mipmapFilter())
+                .write(texture.wrapping()[0])
+                .write(texture.wrapping()[1])
+                .write(texture.wrapping()[2]);
+
+            writer.write(UnsignedByte(image.isCompressed()));
+            if (image.isCompressed())
+                writer.write(image.compressedFormat());
+            else
+                writer.write(image.format()).write(image.storage().alignment());
+            writer.write(image.size()).writeBlob(image.data());
+        }
+
+        /* Materials (only the Phong properties used by the drawables) */
+        writer.write(UnsignedInt(data.materials.size()));
+        for (const Containers::Optional<Trade::PhongMaterialData>& material : data.materials) {
+            writer.write(UnsignedByte(bool(material)));
+            if (!material)
+                continue;
+
+            writer.write(material->ambientColor())
+                .write(material->diffuseColor())
+                .write(material->specularColor())
+                .write(material->shininess())
+                .write(UnsignedByte(material->hasAttribute(Trade::MaterialAttribute::DiffuseTexture)));
+            if (material->hasAttribute(Trade::MaterialAttribute::DiffuseTexture))
+                writer.write(material->diffuseTexture());
+        }
+
+        /* Meshes (raw index/vertex data + attribute layout) */
+        writer.write(UnsignedInt(data.meshes.size()));
+        for (const Containers::Optional<Trade::MeshData>& mesh : data.meshes) {
+            writer.write(UnsignedByte(bool(mesh)));
+            if (!mesh)
+                continue;
+
+            writer.write(mesh->primitive()).write(mesh->vertexCount()).write(UnsignedByte(mesh->isIndexed()));
+            if (mesh->isIndexed())
+                writer.write(mesh->indexType()).write(UnsignedLong(mesh->indexOffset())).write(mesh->indexCount()).writeBlob(mesh->indexData());
+
+            writer.write(mesh->attributeCount());
+            for (UnsignedInt j = 0; j != mesh->attributeCount(); ++j)
+                writer.write(mesh->attributeName(j))
+                    .write(mesh->attributeFormat(j))
+                    .write(UnsignedLong(mesh->attributeOffset(j)))
+                    .write(Long(mesh->attributeStride(j)))
+                    .write(mesh->attributeArraySize(j));
+            writer.writeBlob(mesh->vertexData());
+        }
+
+        /* Scene hierarchy */
+        writer.write(UnsignedByte(data.hasScene)).write(UnsignedLong(data.mappingBound));
+
+        writer.write(UnsignedLong(data.parents.size()));
+        for (const Containers::Pair<UnsignedInt, Int>& parent : data.parents)
+            writer.write(parent.first()).write(parent.second());
+
+        writer.write(UnsignedLong(data.meshesMaterials.size()));
+        for (const Containers::Pair<UnsignedInt, Containers::Pair<UnsignedInt, Int>>& meshMaterial : data.meshesMaterials)
+            writer.write(meshMaterial.first()).write(meshMaterial.second().first()).write(meshMaterial.second().second());
+
+        writer.write(UnsignedLong(data.transformations.size()));
+        for (const Containers::Pair<UnsignedInt, Matrix4>& transformation : data.transformations)
+            writer.write(transformation.first()).write(transformation.second());
+
+        writer.finish();
+
+        // Write to a temporary file first so that a concurrent reader never sees a partial cache
+        const std::string temporary = file + ".tmp";
+        return Utility::Path::write(temporary, writer.data()) && Utility::Path::move(temporary, file);
+    }
+
+    bool Graphics::loadCache(const std::string& file, ImportData& data) const
+    {
+        if (!Utility::Path::exists(file))
+            return false;
+
+        Containers::Optional<Containers::Array<const char, Utility::Path::MapDeleter>> mapped = Utility::Path::mapRead(file);
+        if (!mapped)
+            return false;
+
+        CacheReader reader{*mapped};
+        if (reader.read<UnsignedLong>() != CacheMagic || reader.read<UnsignedInt>() != CacheVersion)
+            return false;
+
+        /* Textures */
+        data.textures = Containers::Array<Containers::Optional<Trade::TextureData>>{reader.readCount<UnsignedInt>(sizeof(UnsignedByte))};
+        Containers::Array<Containers::Optional<CachedImage>> images{data.textures.size()};
+        for (std::size_t i = 0; i != data.textures.size() && reader.valid(); ++i) {
+            if (!reader.read<UnsignedByte>())
+                continue;
+
+            const auto minification = reader.read<SamplerFilter>();
+            const auto magnification = reader.read<SamplerFilter>();
+            const auto mipmap = reader.read<SamplerMipmap>();
+            const auto wrappingX = reader.read<SamplerWrapping>();
+            const auto wrappingY = reader.read<SamplerWrapping>();
+            const auto wrappingZ = reader.read<SamplerWrapping>();
+            data.textures[i] = Trade::TextureData{Trade::TextureType::Texture2D, minification, magnification, mipmap, {wrappingX, wrappingY, wrappingZ}, UnsignedInt(i)};
+
+            CachedImage image{};
+            image.compressed = reader.read<UnsignedByte>();
+            if (image.compressed)
+                image.compressedFormat = reader.read<CompressedPixelFormat>();
+            else {
+                image.format = reader.read<PixelFormat>();
+                image.alignment = reader.read<Int>();
+            }
+            image.size = reader.read<Vector2i>();
+            image.pixels = reader.readBlob();
+            images[i] = image;
+        }
+
+        /* Materials */
+        data.materials = Containers::Array<Containers::Optional<Trade::PhongMaterialData>>{reader.readCount<UnsignedInt>(sizeof(UnsignedByte))};
+        for (std::size_t i = 0; i != data.materials.size() && reader.valid(); ++i) {
+            if (!reader.read<UnsignedByte>())
+                continue;
+
+            Containers::Array<Trade::MaterialAttributeData> attributes;
+            arrayAppend(attributes, Trade::MaterialAttributeData{Trade::MaterialAttribute::AmbientColor, reader.read<Color4>()});
+            arrayAppend(attributes, Trade::MaterialAttributeData{Trade::MaterialAttribute::DiffuseColor, reader.read<Color4>()});
+            arrayAppend(attributes, Trade::MaterialAttributeData{Trade::MaterialAttribute::SpecularColor, reader.read<Color4>()});
+            arrayAppend(attributes, Trade::MaterialAttributeData{Trade::MaterialAttribute::Shininess, reader.read<Float>()});
+            if (reader.read<UnsignedByte>())
+                arrayAppend(attributes, Trade::MaterialAttributeData{Trade::MaterialAttribute::DiffuseTexture, reader.read<UnsignedInt>()});
+
+            data.materials[i] = Trade::MaterialData{Trade::MaterialType::Phong, std::move(attributes)}.as<Trade::PhongMaterialData>();
+        }
+
+        /* Meshes (index/vertex data are views into the mapping, nothing is parsed or copied) */
+        Containers::Array<Containers::Optional<CachedMesh>> meshes{reader.readCount<UnsignedInt>(sizeof(UnsignedByte))};
+        for (std::size_t i = 0; i != meshes.size() && reader.valid(); ++i) {
+            if (!reader.read<UnsignedByte>())
+                continue;
+
+            CachedMesh mesh{};
+            mesh.primitive = reader.read<MeshPrimitive>();
+            mesh.vertexCount = reader.read<UnsignedInt>();
+
+            mesh.indexed = reader.read<UnsignedByte>();
+            if (mesh.indexed) {
+                mesh.indexType = reader.read<MeshIndexType>();
+                mesh.indexOffset = reader.read<UnsignedLong>();
+                mesh.indexCount = reader.read<UnsignedInt>();
+                mesh.indexData = reader.readBlob();
+            }
+
+            mesh.attributes = Containers::Array<CachedAttribute>{Containers::NoInit, reader.readCount<UnsignedInt>(CachedAttributeSize)};
+            for (CachedAttribute& attribute : mesh.attributes) {
+                attribute.name = reader.read<Trade::MeshAttribute>();
+                attribute.format = reader.read<VertexFormat>();
+                attribute.offset = reader.read<UnsignedLong>();
+                attribute.stride = reader.read<Long>();
+                attribute.arraySize = reader.read<UnsignedShort>();
+            }
+
+            mesh.vertexData = reader.readBlob();
+            meshes[i] = std::move(mesh);
+        }
+
+        /* Scene hierarchy */
+        data.hasScene = reader.read<UnsignedByte>();
+        data.mappingBound = reader.read<UnsignedLong>();
+
+        data.parents = Containers::Array<Containers::Pair<UnsignedInt, Int>>{Containers::NoInit, reader.readCount<UnsignedLong>(sizeof(UnsignedInt) + sizeof(Int))};
+        for (Containers::Pair<UnsignedInt, Int>& parent : data.parents) {
+            const auto object = reader.read<UnsignedInt>();
+            parent = {object, reader.read<Int>()};
+        }
+
+        data.meshesMaterials = Containers::Array<Containers::Pair<UnsignedInt, Containers::Pair<UnsignedInt, Int>>>{Containers::NoInit, reader.readCount<UnsignedLong>(2 * sizeof(UnsignedInt) + sizeof(Int))};
+        for (Containers::Pair<UnsignedInt, Containers::Pair<UnsignedInt, Int>>& meshMaterial : data.meshesMaterials) {
+            const auto object = reader.read<UnsignedInt>();
+            const auto mesh = reader.read<UnsignedInt>();
+            meshMaterial = {object, {mesh, reader.read<Int>()}};
+        }
+
+        data.transformations = Containers::Array<Containers::Pair<UnsignedInt, Matrix4>>{Containers::NoInit, reader.readCount<UnsignedLong>(sizeof(UnsignedInt) + sizeof(Matrix4))};
+        for (Containers::Pair<UnsignedInt, Matrix4>& transformation : data.transformations) {
+            const auto object = reader.read<UnsignedInt>();
+            transformation = {object, reader.read<Matrix4>()};
+        }
+
+        // Nothing is built from a truncated or corrupted file (the caller parses the source file instead)
+        if (!reader.finish())
+            return false;
+
+        // Objects, meshes, materials and textures referenced by the scene exist (addImported() indexes them directly)
+        if (data.mappingBound > mapped->size()) // one object handle per id, bounded by the file size as any other count
+            return false;
+
+        for (const Containers::Optional<Trade::PhongMaterialData>& material : data.materials)
+            if (material && material->hasAttribute(Trade::MaterialAttribute::DiffuseTexture) && material->diffuseTexture() >= data.textures.size())
+                return false;
+
+        for (const Containers::Pair<UnsignedInt, Int>& parent : data.parents)
+            if (parent.first() >= data.mappingBound || parent.second() < -1 || (parent.second() != -1 && std::size_t(parent.second()) >= data.mappingBound))
+                return false;
+
+        for (const Containers::Pair<UnsignedInt, Containers::Pair<UnsignedInt, Int>>& meshMaterial : data.meshesMaterials) {
+            const Int material = meshMaterial.second().second();
+            if (meshMaterial.first() >= data.mappingBound || meshMaterial.second().first() >= meshes.size() || material < -1 || (material != -1 && std::size_t(material) >= data.materials.size()))
+                return false;
+        }
+
+        for (const Containers::Pair<UnsignedInt, Matrix4>& transformation : data.transformations)
+            if (transformation.first() >= data.mappingBound)
+                return false;
+
+        // Images are small compared to meshes and are released right after upload, copy them out of the mapping
+        data.images = Containers::Array<Containers::Optional<Trade::ImageData2D>>{images.size()};
+        for (std::size_t i = 0; i != images.size(); ++i) {
+            if (!images[i])
+                continue;
+
+            const CachedImage& image = *images[i];
+            if (!validImage(image))
+                return false;
+
+            Containers::Array<char> copy{Containers::NoInit, image.pixels.size()};
+            Utility::copy(image.pixels, copy);
+            if (image.compressed)
+                data.images[i] = Trade::ImageData2D{image.compressedFormat, image.size, std::move(copy)};
+            else
+                data.images[i] = Trade::ImageData2D{PixelStorage{}.setAlignment(image.alignment), image.format, image.size, std::move(copy)};
+        }
+
+        data.meshes = Containers::Array<Containers::Optional<Trade::MeshData>>{meshes.size()};
+        for (std::size_t i = 0; i != meshes.size(); ++i) {
+            if (!meshes[i])
+                continue;
+
+            const CachedMesh& mesh = *meshes[i];
+            if (!validMesh(mesh))
+                return false;
+
+            Containers::Array<Trade::MeshAttributeData> attributes{mesh.attributes.size()};
+            for (std::size_t j = 0; j != attributes.size(); ++j) {
+                const CachedAttribute& attribute = mesh.attributes[j];
+                attributes[j] = Trade::MeshAttributeData{attribute.name, attribute.format, std::size_t(attribute.offset), mesh.vertexCount, std::ptrdiff_t(attribute.stride), attribute.arraySize};
+            }
+
+            if (mesh.indexed) {
+                const Trade::MeshIndexData indices{mesh.indexType, mesh.indexData.slice(mesh.indexOffset, mesh.indexOffset + std::size_t(mesh.indexCount) * meshIndexTypeSize(mesh.indexType))};
+                data.meshes[i] = Trade::MeshData{mesh.primitive, Trade::DataFlags{}, mesh.indexData, indices, Trade::DataFlags{}, mesh.vertexData, std::move(attributes), mesh.vertexCount};
+            }
+            else
+                data.meshes[i] = Trade::MeshData{mesh.primitive, Trade::DataFlags{}, mesh.vertexData, std::move(attributes), mesh.vertexCount};
+        }
+
+        // Keep the file mapped as long as the meshes are referencing it
+        data.mapping = std::move(mapped);
+
+        return true;
+    }
+} // namespace graphics_lib
@@ -25,9 +25,17 @@
 #ifndef GRAPHICSLIB_CAMERA_HANDLE_HPP
 #define GRAPHICSLIB_CAMERA_HANDLE_HPP
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <vector>
+
 #include <Magnum/GL/DefaultFramebuffer.h>
 #include <Magnum/SceneGraph/Camera.h>
 
+#include "graphics_lib/drawbles/AbstractDrawable.hpp"
+#include "graphics_lib/drawbles/UniformQueue.hpp"
+
 // Inspired from https://github.com/alexesDev/magnum-tips
 namespace graphics_lib {
     namespace cameras {
@@ -74,6 +82,21 @@ namespace graphics_lib {
 
             Containers::Array<Math::Vector<N, Float>>& pose() { return _pose; }
 
+            // Skip drawables whose bounds are outside of the view frustum (3D only, enabled by default)
+            CameraHandle& setCulling(const bool& culling)
+            {
+                _culling = culling;
+                markChanged();
+                return *this;
+            }
+
+            // Flag raised on every camera change
+            CameraHandle& setRedrawFlag(std::atomic<bool>* flag)
+            {
+                _changed = flag;
+                return *this;
+            }
+
             // Partial fill vector with variadic template and fold expression with callable
             // https://stackoverflow.com/questions/7230621/how-can-i-iterate-over-a-packed-variadic-template-argument-list
             template <typename... Args>
@@ -106,6 +129,8 @@ namespace graphics_lib {
 
                     // Pitch
                     _objects[1]->translate(-_pose[1]).rotate(Rad(s.y()), Vector3::yAxis(-1)).translate(_pose[1]);
+
+                    markChanged();
                 }
                 else {
                     std::cout << "hello" << std::endl;
@@ -120,6 +145,8 @@ namespace graphics_lib {
                     const Vector3 distance = _pose[1] - _objects[2]->transformation().translation();
 
                     _objects[2]->translate(distance * (1.0f - (shift > 0 ? 1 / 0.85f : 0.85f)));
+
+                    markChanged();
                 }
                 else {
                     std::cout << "hello" << std::endl;
@@ -131,7 +158,36 @@ namespace graphics_lib {
             /* Wrapped functions */
             CameraHandle& draw(SceneGraph::DrawableGroup<N, Float>& _group)
             {
-                _camera->draw(_group);
+                _camera->draw(visible(_group));
+
+                return *this;
+            }
+
+            // Draw sorted by state, drawables sharing shader/texture/material are drawn consecutively
+            // (all the drawables of the group have to derive from drawables::AbstractDrawable)
+            // With a uniform queue, drawables supporting it are drawn through per-draw uniform buffers (3D only)
+            CameraHandle& drawQueued(SceneGraph::DrawableGroup<N, Float>& group, drawables::UniformQueue* uniforms = nullptr)
+            {
+                auto transformations = visible(group);
+
+                std::vector<std::pair<drawables::SortKey, size_t>> queue;
+                queue.reserve(transformations.size());
+                for (size_t i = 0; i < transformations.size(); ++i)
+                    queue.emplace_back(static_cast<drawables::AbstractDrawable<N>&>(transformations[i].first.get()).sortKey(), i);
+
+                std::sort(queue.begin(), queue.end());
+
+                drawables::RenderState state;
+                for (const auto& entry : queue) {
+                    auto& drawable = static_cast<drawables::AbstractDrawable<N>&>(transformations[entry.second].first.get());
+                    if (!uniforms || !drawable.enqueue(transformations[entry.second].second, *uniforms))
+                        drawable.drawQueued(transformations[entry.second].second, *_camera, state);
+                }
+
+                if constexpr (N == 3) {
+                    if (uniforms)
+                        uniforms->submit(*_camera);
+                }
 
                 return *this;
             }
@@ -141,6 +197,7 @@ namespace graphics_lib {
             CameraHandle& setViewport(const Vector2i& size)
             {
                 _camera->setViewport(size);
+                markChanged();
 
                 return *this;
             }
@@ -162,12 +219,43 @@ namespace graphics_lib {
             // Camera speed
             Vector2 _speed;
 
+            // Redraw flag (owned by the application)
+            std::atomic<bool>* _changed = nullptr;
+
+            // Frustum culling
+            bool _culling = true;
+
+            // Visible drawables of the group (with their camera-space transformation): not hidden and intersecting the view frustum
+            std::vector<std::pair<std::reference_wrapper<SceneGraph::Drawable<N, Float>>, std::conditional_t<N == 3, Matrix4, Matrix3>>> visible(SceneGraph::DrawableGroup<N, Float>& group)
+            {
+                auto transformations = _camera->drawableTransformations(group);
+                Frustum frustum;
+                if constexpr (N == 3)
+                    frustum = Frustum::fromMatrix(_camera->projectionMatrix());
+
+                transformations.erase(std::remove_if(transformations.begin(), transformations.end(), [this, &frustum](const auto& drawable) {
+                    const auto& abstract = static_cast<const drawables::AbstractDrawable<N>&>(drawable.first.get());
+                    return !abstract.isVisible() || (_culling && !abstract.inFrustum(drawable.second, frustum));
+                }),
+                    transformations.end());
+
+                return transformations;
+            }
+
+            void markChanged()
+            {
+                if (_changed)
+                    *_changed = true;
+            }
+
             void updatePose()
             {
                 if constexpr (N == 3)
                     _objects[2]->setTransformation(Matrix4::lookAt(_pose[0], _pose[1], _pose[2]));
                 else
                     std::cout << "Hello2" << std::endl;
+
+                markChanged();
             }
         };
     } // namespace cameras
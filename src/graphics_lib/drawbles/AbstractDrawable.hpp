@@ -25,19 +25,80 @@
 #ifndef GRAPHICSLIB_ABSTRACT_DRAWABLE_HPP
 #define GRAPHICSLIB_ABSTRACT_DRAWABLE_HPP
 
+#include <cstdint>
+#include <tuple>
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Magnum/GL/Mesh.h>
+#include <Magnum/GL/MeshView.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Frustum.h>
+#include <Magnum/Math/Intersection.h>
+#include <Magnum/Math/Range.h>
+#include <Magnum/Resource.h>
 #include <Magnum/SceneGraph/Drawable.h>
 
 namespace graphics_lib {
     namespace drawables {
+        class UniformQueue;
+
+        // Render queue sort key [shader, texture, material/color, mesh]
+        using SortKey = std::tuple<std::uintptr_t, std::uintptr_t, std::uintptr_t, std::uintptr_t>;
+
+        // State left by the previous drawable of a render queue
+        struct RenderState {
+            const void* shader = nullptr;
+            const void* texture = nullptr;
+            const void* material = nullptr;
+            Containers::Optional<Color4> color;
+        };
+
+        // Simplified version of a mesh: range of its index buffer and bound of the geometric error (mesh units)
+        struct DetailLevel {
+            UnsignedInt offset, count;
+            Float error;
+        };
+
+        // Properties overriding those of all the drawables of a subtree (nested overrides refine the enclosing ones)
+        struct Override {
+            Containers::Optional<Color4> color;
+            bool visible = true;
+            const Override* parent = nullptr;
+
+            Containers::Optional<Color4> resolvedColor() const { return color ? color : (parent ? parent->resolvedColor() : Containers::NullOpt); }
+            bool resolvedVisible() const { return visible && (!parent || parent->resolvedVisible()); }
+        };
+
+        // Object carrying the nearest override of its subtree (drawables read it from their object at draw time)
+        class Overridable {
+        public:
+            virtual ~Overridable() = default;
+
+            const Override* activeOverride() const { return _override; }
+
+        protected:
+            const Override* _override = nullptr;
+        };
+
         template <size_t N>
         class AbstractDrawable : public SceneGraph::Drawable<N, Float> {
         public:
             explicit AbstractDrawable(SceneGraph::Object<typename std::conditional<N == 3, SceneGraph::MatrixTransformation3D, SceneGraph::MatrixTransformation2D>::type>& object, SceneGraph::DrawableGroup<N, Float>& group)
-                : SceneGraph::Drawable<N, Float>{object, &group} {}
+                : SceneGraph::Drawable<N, Float>{object, &group},
+                  _overridable(dynamic_cast<const Overridable*>(&object)) {}
 
             AbstractDrawable<N>& setMesh(GL::Mesh& mesh)
             {
                 _mesh = std::move(mesh);
+                _sharedMesh = Resource<GL::Mesh>{};
+                return *this;
+            }
+
+            // Reference a mesh shared with other drawables (not owned)
+            AbstractDrawable<N>& setMesh(const Resource<GL::Mesh>& mesh)
+            {
+                _sharedMesh = mesh;
                 return *this;
             }
 
@@ -47,12 +108,132 @@ namespace graphics_lib {
                 return *this;
             }
 
+            // Bounding box of the mesh (before the prior transformation); drawables without it are never culled
+            AbstractDrawable<N>& setBoundingBox(const Math::Range<N, Float>& box)
+            {
+                _boundingBox = box;
+                return *this;
+            }
+
+            const Containers::Optional<Math::Range<N, Float>>& boundingBox() const { return _boundingBox; }
+
+            // Simplified versions of the mesh (finest first), drawn when their error is not visible on screen
+            AbstractDrawable<N>& setDetailLevels(Containers::ArrayView<const DetailLevel> levels)
+            {
+                _detailLevels = Containers::Array<DetailLevel>{Containers::NoInit, levels.size()};
+                for (size_t i = 0; i < levels.size(); ++i)
+                    _detailLevels[i] = levels[i];
+
+                return *this;
+            }
+
+            const typename std::conditional<N == 3, Matrix4, Matrix3>::type& priorTransformation() const { return _priorTransformation; }
+
+            // Visibility and color set by the overrides of the enclosing subtrees
+            bool isVisible() const
+            {
+                const Override* active = _overridable ? _overridable->activeOverride() : nullptr;
+                return !active || active->resolvedVisible();
+            }
+
+            Containers::Optional<Color4> overrideColor() const
+            {
+                const Override* active = _overridable ? _overridable->activeOverride() : nullptr;
+                return active ? active->resolvedColor() : Containers::NullOpt;
+            }
+
+            // Whether the bounding sphere of the drawable intersects the frustum (both in camera space, 3D only)
+            bool inFrustum(const typename std::conditional<N == 3, Matrix4, Matrix3>::type& transformationMatrix, const Frustum& frustum) const
+            {
+                if constexpr (N == 3) {
+                    if (!_boundingBox)
+                        return true;
+
+                    const Matrix4 transformation = transformationMatrix * _priorTransformation;
+
+                    return Math::Intersection::sphereFrustum(transformation.transformPoint(_boundingBox->center()),
+                        0.5f * _boundingBox->size().length() * transformation.scaling().max(), frustum);
+                }
+                else
+                    return true;
+            }
+
+            // Key used to sort the render queue (drawables sharing state are drawn consecutively)
+            virtual SortKey sortKey() { return SortKey{0, 0, 0, reinterpret_cast<std::uintptr_t>(&mesh())}; }
+
+            // Draw as part of a render queue, skipping the state already set (plain draw by default)
+            virtual void drawQueued(const typename std::conditional<N == 3, Matrix4, Matrix3>::type& transformationMatrix, SceneGraph::Camera<N, Float>& camera, RenderState& state)
+            {
+                state = RenderState{};
+                this->draw(transformationMatrix, camera);
+            }
+
+            // Add the draw to a uniform buffer queue; false if not supported (drawn through drawQueued() instead)
+            virtual bool enqueue(const typename std::conditional<N == 3, Matrix4, Matrix3>::type&, UniformQueue&) { return false; }
+
         protected:
-            // Mesh
+            friend class UniformQueue;
+
+            // Mesh (owned) and shared mesh (takes precedence if set)
             GL::Mesh _mesh;
+            Resource<GL::Mesh> _sharedMesh;
+
+            GL::Mesh& mesh() { return _sharedMesh ? *_sharedMesh : _mesh; }
+
+            // Draw the coarsest level whose error projects below DetailPixelThreshold (full mesh without levels)
+            template <typename Shader>
+            void drawMesh(Shader& shader, const typename std::conditional<N == 3, Matrix4, Matrix3>::type& transformation, SceneGraph::Camera<N, Float>& camera)
+            {
+                const size_t level = detailLevel(transformation, camera);
+
+                if (!level) {
+                    shader.draw(mesh());
+                    return;
+                }
+
+                GL::MeshView view{mesh()};
+                view.setCount(_detailLevels[level - 1].count).setIndexRange(_detailLevels[level - 1].offset);
+                shader.draw(view);
+            }
+
+            // Level to draw (0 is the full mesh)
+            size_t detailLevel(const typename std::conditional<N == 3, Matrix4, Matrix3>::type& transformation, SceneGraph::Camera<N, Float>& camera) const
+            {
+                size_t level = 0;
+
+                if constexpr (N == 3) {
+                    if (_detailLevels.isEmpty())
+                        return level;
+
+                    // Nearest point of the bounding sphere
+                    const Vector3 center = _boundingBox ? _boundingBox->center() : Vector3{};
+                    const Float radius = _boundingBox ? 0.5f * _boundingBox->size().length() : 0.0f, scaling = transformation.scaling().max();
+                    const Float depth = -transformation.transformPoint(center).z() - radius * scaling;
+
+                    if (depth <= 0.0f)
+                        return level;
+
+                    const Float pixels = scaling * camera.projectionMatrix()[1][1] * camera.viewport().y() / (2.0f * depth);
+
+                    while (level < _detailLevels.size() && _detailLevels[level].error * pixels < DetailPixelThreshold)
+                        ++level;
+                }
+
+                return level;
+            }
 
             // Prior and posterior transformation
             typename std::conditional<N == 3, Matrix4, Matrix3>::type _priorTransformation;
+
+            // Bounds (culling)
+            Containers::Optional<Math::Range<N, Float>> _boundingBox;
+
+            // Levels of detail and largest on-screen error allowed (pixels)
+            Containers::Array<DetailLevel> _detailLevels;
+            static constexpr Float DetailPixelThreshold = 1.0f;
+
+            // Object overrides (null if the object does not support them)
+            const Overridable* _overridable;
         };
     } // namespace drawables
 } // namespace graphics_lib
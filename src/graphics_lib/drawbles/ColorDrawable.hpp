@@ -42,7 +42,7 @@ namespace graphics_lib {
             {
                 _shader
                     .setTransformationProjectionMatrix(camera.projectionMatrix() * transformationMatrix * AbstractDrawable<N>::_priorTransformation)
-                    .draw(AbstractDrawable<N>::_mesh);
+                    .draw(AbstractDrawable<N>::mesh());
             }
 
             // Shaders
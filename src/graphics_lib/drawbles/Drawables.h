@@ -37,15 +37,38 @@ namespace graphics_lib {
         typedef ColorDrawable<3> ColorDrawable3D;
         typedef ColorDrawable<2> ColorDrawable2D;
 
+        template <size_t>
+        class InstancedDrawable;
+        typedef InstancedDrawable<3> InstancedDrawable3D;
+
         template <size_t>
         class PhongDrawable;
         typedef PhongDrawable<3> PhongDrawable3D;
         typedef PhongDrawable<2> PhongDrawable2D;
 
+        template <size_t>
+        class PointCloudDrawable;
+        typedef PointCloudDrawable<3> PointCloudDrawable3D;
+
+        template <size_t>
+        class ScalarDrawable;
+        typedef ScalarDrawable<3> ScalarDrawable3D;
+        typedef ScalarDrawable<2> ScalarDrawable2D;
+
+        template <size_t>
+        class StreamDrawable;
+        typedef StreamDrawable<3> StreamDrawable3D;
+        typedef StreamDrawable<2> StreamDrawable2D;
+
         template <size_t>
         class TextureDrawable;
         typedef TextureDrawable<3> TextureDrawable3D;
         typedef TextureDrawable<2> TextureDrawable2D;
+
+        template <size_t>
+        class TrajectoryDrawable;
+        typedef TrajectoryDrawable<3> TrajectoryDrawable3D;
+        typedef TrajectoryDrawable<2> TrajectoryDrawable2D;
     } // namespace drawables
 } // namespace graphics_lib
 
@@ -0,0 +1,195 @@
+/*
+    This file is part of graphics-lib.
+
+    Copyright (c) 2020, 2021, 2022 Bernardo Fichera <bernardo.fichera@gmail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef GRAPHICSLIB_INSTANCED_DRAWABLE_HPP
+#define GRAPHICSLIB_INSTANCED_DRAWABLE_HPP
+
+#include "graphics_lib/drawbles/AbstractDrawable.hpp"
+#include <Eigen/Core>
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Quaternion.h>
+#include <Magnum/Shaders/Phong.h>
+
+namespace graphics_lib {
+    namespace drawables {
+        // One shared mesh drawn many times in a single call (per-instance transformation and color)
+        template <size_t N = 3>
+        class InstancedDrawable : public AbstractDrawable<N> {
+        public:
+            struct InstanceData {
+                Matrix4 transformation;
+                Matrix3x3 normalMatrix;
+                Color3 color;
+            };
+
+            // "uniformShader" draws the instances with a single color (override color), it must not use vertex colors
+            explicit InstancedDrawable(SceneGraph::Object<std::conditional_t<N == 3, SceneGraph::MatrixTransformation3D, SceneGraph::MatrixTransformation2D>>& object, SceneGraph::DrawableGroup<N, Float>& group, Shaders::PhongGL& shader, Shaders::PhongGL& uniformShader)
+                : AbstractDrawable<N>(object, group),
+                  _shader(shader),
+                  _uniformShader(uniformShader) {}
+
+            // Per-instance buffer (owned by the drawable so that it can be updated without touching the shared mesh)
+            GL::Buffer& instanceBuffer() { return _instanceBuffer; }
+
+            // Bounding box of the shared mesh (the bounding box of the drawable covers all the instances)
+            InstancedDrawable& setInstanceBounds(const Range3D& box)
+            {
+                _instanceBounds = box;
+                return *this;
+            }
+
+            // Set instances from positions, colors (white if empty, one row per instance otherwise) and uniform scale
+            InstancedDrawable& setInstances(const Eigen::Matrix<double, Eigen::Dynamic, 3>& positions, const Eigen::Matrix<double, Eigen::Dynamic, 3>& colors, const double& scale = 1)
+            {
+                if (!checkColors(positions.rows(), colors))
+                    return *this;
+
+                const Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor> p = positions.cast<float>();
+                resize(p.rows());
+
+                for (size_t i = 0; i < _instances.size(); i++)
+                    _instances[i].transformation = Matrix4::translation(Vector3::from(p.row(i).data())) * Matrix4::scaling(Vector3{Float(scale)});
+
+                return upload(colors);
+            }
+
+            // Set instances from full poses, one row per instance: either a 4x4 homogeneous transformation in row-major order (16 columns,
+            // any scaling allowed) or position and unit quaternion [x y z qx qy qz qw] (7 columns)
+            InstancedDrawable& setInstancePoses(const Eigen::Ref<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>& poses, const Eigen::Matrix<double, Eigen::Dynamic, 3>& colors)
+            {
+                if (poses.cols() != 16 && poses.cols() != 7) {
+                    Warning{} << "Expected poses with 16 or 7 columns, got" << poses.cols();
+                    return *this;
+                }
+
+                if (!checkColors(poses.rows(), colors))
+                    return *this;
+
+                const Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> p = poses.cast<float>();
+                resize(p.rows());
+
+                for (size_t i = 0; i < _instances.size(); i++) {
+                    const Float* pose = p.row(i).data();
+
+                    // Row-major rows read as column-major matrices are the transposed ones
+                    if (p.cols() == 16)
+                        _instances[i].transformation = Matrix4::from(pose).transposed();
+                    else
+                        _instances[i].transformation = Matrix4::from(Quaternion{Vector3::from(pose + 3), pose[6]}.toMatrix(), Vector3::from(pose));
+                }
+
+                return upload(colors);
+            }
+
+        private:
+            void draw(const std::conditional_t<N == 3, Matrix4, Matrix3>& transformationMatrix, SceneGraph::Camera<N, Float>& camera) override
+            {
+                if (!_instanceCount)
+                    return;
+
+                auto transformation = transformationMatrix * AbstractDrawable<N>::_priorTransformation;
+
+                // Override color replaces the per-instance colors (shader without vertex colors)
+                const Containers::Optional<Color4> color = AbstractDrawable<N>::overrideColor();
+                Shaders::PhongGL& shader = color ? _uniformShader : _shader;
+                if (color)
+                    shader.setDiffuseColor(*color);
+
+                shader
+                    .setTransformationMatrix(transformation)
+                    .setNormalMatrix(transformation.normalMatrix())
+                    .setProjectionMatrix(camera.projectionMatrix())
+                    .draw(AbstractDrawable<N>::_mesh);
+            }
+
+            // Colors are either not given or given for every instance
+            bool checkColors(const Eigen::Index& count, const Eigen::Matrix<double, Eigen::Dynamic, 3>& colors) const
+            {
+                if (colors.rows() && colors.rows() != count) {
+                    Warning{} << "Expected" << count << "instance colors, got" << colors.rows();
+                    return false;
+                }
+
+                return true;
+            }
+
+            void resize(const Eigen::Index& count)
+            {
+                if (_instances.size() != size_t(count))
+                    _instances = Containers::Array<InstanceData>{Containers::NoInit, size_t(count)};
+            }
+
+            // Complete the instances (normal matrices, colors, bounds) from their transformations and upload them
+            InstancedDrawable& upload(const Eigen::Matrix<double, Eigen::Dynamic, 3>& colors)
+            {
+                const Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor> c = colors.cast<float>();
+
+                for (size_t i = 0; i < _instances.size(); i++) {
+                    _instances[i].normalMatrix = _instances[i].transformation.normalMatrix();
+                    _instances[i].color = c.rows() ? Color3::from(c.row(i).data()) : Color3{1.0f};
+                }
+
+                // Box of the transformed corners of the shared mesh box
+                if (_instanceBounds && !_instances.isEmpty()) {
+                    Range3D box{_instances[0].transformation.translation(), _instances[0].transformation.translation()};
+                    for (const InstanceData& instance : _instances)
+                        for (UnsignedInt corner = 0; corner < 8; ++corner) {
+                            const Vector3 point = instance.transformation.transformPoint({(corner & 1) ? _instanceBounds->max().x() : _instanceBounds->min().x(),
+                                (corner & 2) ? _instanceBounds->max().y() : _instanceBounds->min().y(),
+                                (corner & 4) ? _instanceBounds->max().z() : _instanceBounds->min().z()});
+                            box = Range3D{Math::min(box.min(), point), Math::max(box.max(), point)};
+                        }
+                    AbstractDrawable<N>::setBoundingBox(box);
+                }
+
+                // Same size -> update in place, otherwise (re)allocate the storage
+                if (_instanceCount == _instances.size())
+                    _instanceBuffer.setSubData(0, _instances);
+                else {
+                    _instanceBuffer.setData(_instances, GL::BufferUsage::DynamicDraw);
+                    _instanceCount = _instances.size();
+                    AbstractDrawable<N>::_mesh.setInstanceCount(_instanceCount);
+                }
+
+                return *this;
+            }
+
+            // Shaders
+            Shaders::PhongGL& _shader;
+            Shaders::PhongGL& _uniformShader;
+
+            // Instances (staging array, GPU buffer and number of instances currently allocated)
+            Containers::Array<InstanceData> _instances;
+            GL::Buffer _instanceBuffer;
+            size_t _instanceCount = 0;
+
+            // Bounding box of the shared mesh
+            Containers::Optional<Range3D> _instanceBounds;
+        };
+
+    } // namespace drawables
+} // namespace graphics_lib
+
+#endif // GRAPHICSLIB_INSTANCED_DRAWABLE_HPP
@@ -26,6 +26,10 @@
 #define GRAPHICSLIB_PHONG_DRAWABLE_HPP
 
 #include "graphics_lib/drawbles/AbstractDrawable.hpp"
+#include "graphics_lib/drawbles/UniformQueue.hpp"
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Packing.h>
+#include <Magnum/Resource.h>
 #include <Magnum/Shaders/Phong.h>
 #include <Magnum/Trade/PhongMaterialData.h>
 
@@ -41,6 +45,14 @@ namespace graphics_lib {
             PhongDrawable& setMaterial(Trade::PhongMaterialData& material)
             {
                 _material = std::move(material);
+                _sharedMaterial = Resource<Trade::PhongMaterialData>{};
+                return *this;
+            }
+
+            // Reference a material shared with other drawables (not owned)
+            PhongDrawable& setMaterial(const Resource<Trade::PhongMaterialData>& material)
+            {
+                _sharedMaterial = material;
                 return *this;
             }
 
@@ -50,40 +62,129 @@ namespace graphics_lib {
                 return *this;
             }
 
+            SortKey sortKey() override
+            {
+                // Same colors next to each other (packed to 32 bits), materials by address
+                const Containers::Optional<Color4> diffuse = diffuseColor();
+
+                std::uintptr_t key = 0;
+                if (material() && !diffuse)
+                    key = reinterpret_cast<std::uintptr_t>(material());
+                else if (diffuse) {
+                    const Color4ub color = Math::pack<Color4ub>(Math::clamp(*diffuse, 0.0f, 1.0f));
+                    key = (UnsignedInt(color.r()) << 24) | (UnsignedInt(color.g()) << 16) | (UnsignedInt(color.b()) << 8) | UnsignedInt(color.a());
+                }
+
+                return SortKey{reinterpret_cast<std::uintptr_t>(&_shader), 0, key, reinterpret_cast<std::uintptr_t>(&AbstractDrawable<N>::mesh())};
+            }
+
+            void drawQueued(const typename std::conditional<N == 3, Matrix4, Matrix3>::type& transformationMatrix, SceneGraph::Camera<N, Float>& camera, RenderState& state) override
+            {
+                const Containers::Optional<Color4> diffuse = diffuseColor();
+                if (!material() && !diffuse)
+                    return;
+
+                auto transformation = transformationMatrix * AbstractDrawable<N>::_priorTransformation;
+
+                // Projection is the same for the whole queue
+                if (state.shader != &_shader) {
+                    state = RenderState{};
+                    state.shader = &_shader;
+                    _shader.setProjectionMatrix(camera.projectionMatrix());
+                }
+
+                if (material() && !diffuse) {
+                    if (state.material != material()) {
+                        _shader
+                            .setAmbientColor(material()->ambientColor())
+                            .setDiffuseColor(material()->diffuseColor())
+                            .setSpecularColor(material()->specularColor())
+                            .setShininess(material()->shininess());
+                        state.material = material();
+                        state.color = Containers::NullOpt;
+                    }
+                }
+                else if (state.material || !state.color || *state.color != *diffuse) {
+                    _shader.setDiffuseColor(*diffuse);
+                    state.material = nullptr;
+                    state.color = *diffuse;
+                }
+
+                _shader
+                    .setTransformationMatrix(transformation)
+                    .setNormalMatrix(transformation.normalMatrix());
+
+                AbstractDrawable<N>::drawMesh(_shader, transformation, camera);
+            }
+
+            bool enqueue(const typename std::conditional<N == 3, Matrix4, Matrix3>::type& transformationMatrix, UniformQueue& queue) override
+            {
+                if constexpr (N == 3) {
+                    const Containers::Optional<Color4> diffuse = diffuseColor();
+                    if (!material() && !diffuse)
+                        return true;
+
+                    Shaders::PhongMaterialUniform uniform = queue.material();
+                    if (Trade::PhongMaterialData* phong = material(); phong && !diffuse)
+                        uniform
+                            .setAmbientColor(phong->ambientColor())
+                            .setDiffuseColor(phong->diffuseColor())
+                            .setSpecularColor(phong->specularColor())
+                            .setShininess(phong->shininess());
+                    else
+                        uniform.setDiffuseColor(*diffuse);
+
+                    queue.add(*this, transformationMatrix * AbstractDrawable<N>::_priorTransformation, uniform);
+                    return true;
+                }
+                else
+                    return false;
+            }
+
         protected:
-            // Material
+            // Material (owned) and shared material (takes precedence if set)
             Containers::Optional<Trade::PhongMaterialData> _material;
+            Resource<Trade::PhongMaterialData> _sharedMaterial;
+
+            Trade::PhongMaterialData* material() { return _sharedMaterial ? &*_sharedMaterial : (_material ? &*_material : nullptr); }
 
             // Color
             Containers::Optional<Color4> _color;
 
+            // Color used instead of the material (override color first)
+            Containers::Optional<Color4> diffuseColor() const
+            {
+                Containers::Optional<Color4> color = AbstractDrawable<N>::overrideColor();
+                return color ? color : _color;
+            }
+
         private:
             void draw(const typename std::conditional<N == 3, Matrix4, Matrix3>::type& transformationMatrix, SceneGraph::Camera<N, Float>& camera) override
             {
                 auto transformation = transformationMatrix * AbstractDrawable<N>::_priorTransformation;
+                const Containers::Optional<Color4> diffuse = diffuseColor();
 
-                if (_material)
+                if (material() && !diffuse)
                     _shader
-                        .setAmbientColor(_material->ambientColor())
-                        .setDiffuseColor(_material->diffuseColor())
-                        .setSpecularColor(_material->specularColor())
-                        .setShininess(_material->shininess())
-                        // .setLightPositions({{camera.cameraMatrix().transformPoint({0.0f, 2.0f, 3.0f}), 0.0f},
-                        //     {camera.cameraMatrix().transformPoint({0.0f, -2.0f, 3.0f}), 0.0f}})
-                        .setTransformationMatrix(transformation)
-                        .setNormalMatrix(transformation.normalMatrix())
-                        .setProjectionMatrix(camera.projectionMatrix())
-                        .draw(AbstractDrawable<N>::_mesh);
+                        .setAmbientColor(material()->ambientColor())
+                        .setDiffuseColor(material()->diffuseColor())
+                        .setSpecularColor(material()->specularColor())
+                        .setShininess(material()->shininess());
                 // if color is present (but not texture and material) use color shader (Phong) with fewer color options
-                else if (_color)
+                else if (diffuse)
                     _shader
-                        .setDiffuseColor(*_color)
-                        // .setLightPositions({{camera.cameraMatrix().transformPoint({0.0f, 2.0f, 3.0f}), 0.0f},
-                        //     {camera.cameraMatrix().transformPoint({0.0f, -2.0f, 3.0f}), 0.0f}})
-                        .setTransformationMatrix(transformation)
-                        .setNormalMatrix(transformation.normalMatrix())
-                        .setProjectionMatrix(camera.projectionMatrix())
-                        .draw(AbstractDrawable<N>::_mesh);
+                        .setDiffuseColor(*diffuse);
+                else
+                    return;
+
+                _shader
+                    // .setLightPositions({{camera.cameraMatrix().transformPoint({0.0f, 2.0f, 3.0f}), 0.0f},
+                    //     {camera.cameraMatrix().transformPoint({0.0f, -2.0f, 3.0f}), 0.0f}})
+                    .setTransformationMatrix(transformation)
+                    .setNormalMatrix(transformation.normalMatrix())
+                    .setProjectionMatrix(camera.projectionMatrix());
+
+                AbstractDrawable<N>::drawMesh(_shader, transformation, camera);
             }
 
             // Shaders
@@ -0,0 +1,285 @@
+/*
+    This file is part of graphics-lib.
+
+    Copyright (c) 2020, 2021, 2022 Bernardo Fichera <bernardo.fichera@gmail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef GRAPHICSLIB_POINT_CLOUD_DRAWABLE_HPP
+#define GRAPHICSLIB_POINT_CLOUD_DRAWABLE_HPP
+
+#include "graphics_lib/drawbles/ScalarDrawable.hpp"
+#include <algorithm>
+#include <future>
+#include <queue>
+#include <vector>
+
+#include <Corrade/Containers/GrowableArray.h>
+#include <Magnum/GL/Renderer.h>
+#include <Magnum/Math/Frustum.h>
+#include <Magnum/Math/Intersection.h>
+#include <Magnum/Math/Range.h>
+
+namespace graphics_lib {
+    namespace drawables {
+        // Point cloud stored as an octree: every node keeps a uniform subsample of its points (contiguous in the vertex buffer)
+        // and the finer levels are drawn only where they are visible and dense enough on screen (within a point budget)
+        template <size_t N = 3>
+        class PointCloudDrawable : public ScalarDrawable<N> {
+        public:
+            explicit PointCloudDrawable(SceneGraph::Object<SceneGraph::MatrixTransformation3D>& object, SceneGraph::DrawableGroup<3, Float>& group, shaders::ScalarColorGL<3>& shader)
+                : ScalarDrawable<N>(object, group, shader) {}
+
+            // Maximum number of points drawn per frame
+            PointCloudDrawable& setPointBudget(const size_t& budget)
+            {
+                _budget = budget;
+                return *this;
+            }
+
+            // Build the octree (in parallel) and upload positions
+            PointCloudDrawable& setPoints(const Eigen::Matrix<double, Eigen::Dynamic, 3>& positions)
+            {
+                const UnsignedInt count = positions.rows();
+
+                Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor> points = positions.cast<float>();
+
+                // Node points end up contiguous in this permutation
+                _order = Containers::Array<UnsignedInt>{Containers::NoInit, count};
+                for (UnsignedInt i = 0; i < count; i++)
+                    _order[i] = i;
+
+                _nodes = {};
+                if (count) {
+                    const Range3D bounds{Vector3::from(Eigen::Vector3f(points.colwise().minCoeff()).data()), Vector3::from(Eigen::Vector3f(points.colwise().maxCoeff()).data())};
+                    Containers::Pointer<BuildNode> root = build(points.data(), _order.data(), 0, count, bounds, 0);
+                    flatten(*root);
+                    AbstractDrawable<N>::setBoundingBox(bounds);
+                }
+
+                // Upload positions in octree order
+                Containers::Array<Vector3> data{Containers::NoInit, count};
+                for (UnsignedInt i = 0; i < count; i++)
+                    data[i] = Vector3::from(points.data() + 3 * _order[i]);
+
+                _positionBuffer.setData(data, GL::BufferUsage::StaticDraw);
+
+                AbstractDrawable<N>::_mesh.setPrimitive(MeshPrimitive::Points)
+                    .addVertexBuffer(_positionBuffer, 0, shaders::ScalarColorGL3D::Position{})
+                    .addVertexBuffer(ScalarDrawable<N>::scalarBuffer(), 0, shaders::ScalarColorGL3D::Scalar{});
+
+                _refined = Containers::Array<bool>{Containers::ValueInit, _nodes.size()};
+                ScalarDrawable<N>::setVertexCount(count);
+
+                return *this;
+            }
+
+            using ScalarDrawable<N>::updateField;
+
+            // Field is given in the original point order
+            PointCloudDrawable& updateField(const Eigen::Ref<const Eigen::VectorXf>& field) override
+            {
+                if (size_t(field.size()) != _order.size()) {
+                    Warning{} << "Expected a field of" << _order.size() << "values, got" << field.size();
+                    return *this;
+                }
+
+                Eigen::VectorXf ordered(field.size());
+                for (size_t i = 0; i < _order.size(); i++)
+                    ordered(i) = field(_order[i]);
+
+                ScalarDrawable<N>::updateField(Eigen::Ref<const Eigen::VectorXf>(ordered));
+
+                return *this;
+            }
+
+            size_t nodeCount() const { return _nodes.size(); }
+
+        private:
+            // Points kept per node, octree depth limit, depth up to which children are built in parallel, point size limit
+            static constexpr UnsignedInt NodeCapacity = 20000;
+            static constexpr size_t MaxDepth = 20, ParallelDepth = 2;
+            static constexpr Float MaxPointSize = 8.0f;
+
+            struct BuildNode {
+                Range3D bounds;
+                UnsignedInt begin, own;
+                Containers::Pointer<BuildNode> children[8];
+            };
+
+            struct Node {
+                Range3D bounds;
+                Float spacing;
+                UnsignedInt offset, count;
+                Int parent, children[8];
+            };
+
+            struct VisibleNode {
+                UnsignedInt id, count;
+                Float spacing;
+            };
+
+            static Containers::Pointer<BuildNode> build(const Float* points, UnsignedInt* order, const UnsignedInt begin, const UnsignedInt end, const Range3D& bounds, const size_t depth)
+            {
+                Containers::Pointer<BuildNode> node{new BuildNode{bounds, begin, end - begin, {}}};
+
+                if (end - begin <= NodeCapacity || depth >= MaxDepth)
+                    return node;
+
+                // Uniform subsample kept at this level (moved to the front of the range)
+                const UnsignedInt stride = (end - begin) / NodeCapacity;
+                for (UnsignedInt k = 0; k < NodeCapacity; k++)
+                    std::swap(order[begin + k], order[begin + k * stride]);
+
+                node->own = NodeCapacity;
+
+                // Split the remaining points into octants (x, then y, then z) -> octant = 4 * x + 2 * y + z
+                const Vector3 center = bounds.center();
+                UnsignedInt* split[9];
+                split[0] = order + begin + NodeCapacity;
+                split[8] = order + end;
+
+                auto partition = [&](size_t first, size_t last, size_t middle, size_t axis) {
+                    split[middle] = std::partition(split[first], split[last], [&](const UnsignedInt& i) { return points[3 * i + axis] < center[axis]; });
+                };
+
+                partition(0, 8, 4, 0);
+                partition(0, 4, 2, 1);
+                partition(4, 8, 6, 1);
+                partition(0, 2, 1, 2);
+                partition(2, 4, 3, 2);
+                partition(4, 6, 5, 2);
+                partition(6, 8, 7, 2);
+
+                std::future<Containers::Pointer<BuildNode>> futures[8];
+
+                for (size_t o = 0; o < 8; o++) {
+                    if (split[o] == split[o + 1])
+                        continue;
+
+                    Vector3 min = bounds.min(), max = bounds.max();
+                    for (size_t axis = 0; axis < 3; axis++)
+                        (o & (4 >> axis) ? min : max)[axis] = center[axis];
+
+                    const UnsignedInt first = split[o] - order, last = split[o + 1] - order;
+
+                    if (depth < ParallelDepth)
+                        futures[o] = std::async(std::launch::async, build, points, order, first, last, Range3D{min, max}, depth + 1);
+                    else
+                        node->children[o] = build(points, order, first, last, Range3D{min, max}, depth + 1);
+                }
+
+                for (size_t o = 0; o < 8; o++)
+                    if (futures[o].valid())
+                        node->children[o] = futures[o].get();
+
+                return node;
+            }
+
+            Int flatten(const BuildNode& node, const Int parent = -1)
+            {
+                const Int id = _nodes.size();
+
+                arrayAppend(_nodes, Node{node.bounds, node.bounds.size().max() / Math::sqrt(Float(std::max(node.own, 1u))), node.begin, node.own, parent, {-1, -1, -1, -1, -1, -1, -1, -1}});
+
+                for (size_t o = 0; o < 8; o++)
+                    if (node.children[o]) {
+                        const Int child = flatten(*node.children[o], id);
+                        _nodes[id].children[o] = child;
+                    }
+
+                return id;
+            }
+
+            void draw(const Matrix4& transformationMatrix, SceneGraph::Camera<3, Float>& camera) override
+            {
+                if (_nodes.isEmpty())
+                    return;
+
+                const Matrix4 transformation = transformationMatrix * AbstractDrawable<N>::_priorTransformation;
+                const Frustum frustum = Frustum::fromMatrix(camera.projectionMatrix() * transformation);
+                const Float scale = transformation.scaling().max() * camera.projectionMatrix()[1][1] * camera.viewport().y() / 2.0f;
+
+                // Projected size (pixels per unit length at the node center)
+                auto pixels = [&](const Node& node) {
+                    return scale / std::max(-transformation.transformPoint(node.bounds.center()).z(), 1.0e-3f);
+                };
+
+                // Largest nodes on screen first
+                std::priority_queue<std::pair<Float, UnsignedInt>> queue;
+                queue.emplace(Constants::inf(), 0);
+
+                _visible.clear();
+                size_t budget = _budget;
+
+                while (!queue.empty() && budget) {
+                    const UnsignedInt id = queue.top().second;
+                    queue.pop();
+
+                    const Node& node = _nodes[id];
+                    if (!Math::Intersection::aabbFrustum(node.bounds.center(), node.bounds.size() / 2.0f, frustum))
+                        continue;
+
+                    const UnsignedInt count = std::min(size_t(node.count), budget);
+                    const Float spacing = node.spacing * pixels(node);
+
+                    _visible.push_back(VisibleNode{id, count, spacing});
+                    budget -= count;
+
+                    // Parent points are drawn at the density of this level
+                    if (node.parent != -1)
+                        _refined[node.parent] = true;
+
+                    // Refine only while the points are sparser than a pixel
+                    if (spacing > 1.0f)
+                        for (const Int child : node.children)
+                            if (child != -1)
+                                queue.emplace(_nodes[child].bounds.size().length() * pixels(_nodes[child]), child);
+                }
+
+                ScalarDrawable<N>::_shader
+                    .setTransformationProjectionMatrix(camera.projectionMatrix() * transformation)
+                    .setRange(ScalarDrawable<N>::_range.x(), ScalarDrawable<N>::_range.y())
+                    .bindColormapTexture(*ScalarDrawable<N>::_colormap);
+
+                for (const VisibleNode& visible : _visible) {
+                    GL::Renderer::setPointSize(Math::clamp(_refined[visible.id] ? 0.5f * visible.spacing : visible.spacing, 1.0f, MaxPointSize));
+                    ScalarDrawable<N>::_shader.draw(AbstractDrawable<N>::_mesh.setBaseVertex(_nodes[visible.id].offset).setCount(visible.count));
+                    _refined[visible.id] = false;
+                }
+            }
+
+            // Octree nodes (depth first, root first) and point permutation (octree order -> original order)
+            Containers::Array<Node> _nodes;
+            Containers::Array<UnsignedInt> _order;
+
+            // Positions in octree order
+            GL::Buffer _positionBuffer;
+
+            // Point budget and per-frame traversal storage
+            size_t _budget = 5000000;
+            std::vector<VisibleNode> _visible;
+            Containers::Array<bool> _refined;
+        };
+
+    } // namespace drawables
+} // namespace graphics_lib
+
+#endif // GRAPHICSLIB_POINT_CLOUD_DRAWABLE_HPP
@@ -0,0 +1,125 @@
+/*
+    This file is part of graphics-lib.
+
+    Copyright (c) 2020, 2021, 2022 Bernardo Fichera <bernardo.fichera@gmail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef GRAPHICSLIB_SCALAR_DRAWABLE_HPP
+#define GRAPHICSLIB_SCALAR_DRAWABLE_HPP
+
+#include "graphics_lib/drawbles/AbstractDrawable.hpp"
+#include "graphics_lib/shaders/ScalarColorGL.hpp"
+#include <Eigen/Core>
+#include <Magnum/GL/Buffer.h>
+
+namespace graphics_lib {
+    namespace drawables {
+        template <size_t N = 3>
+        class ScalarDrawable : public AbstractDrawable<N> {
+        public:
+            explicit ScalarDrawable(SceneGraph::Object<std::conditional_t<N == 3, SceneGraph::MatrixTransformation3D, SceneGraph::MatrixTransformation2D>>& object, SceneGraph::DrawableGroup<N, Float>& group, shaders::ScalarColorGL<N>& shader)
+                : AbstractDrawable<N>(object, group),
+                  _shader(shader) {}
+
+            // Per-vertex scalar buffer (owned by the drawable so that it can be updated without rebuilding the mesh)
+            GL::Buffer& scalarBuffer() { return _scalarBuffer; }
+
+            ScalarDrawable& setColormap(GL::Texture2D& colormap)
+            {
+                _colormap = &colormap;
+                return *this;
+            }
+
+            // Vertices of the mesh, one scalar each (fields of any other size are rejected)
+            ScalarDrawable& setVertexCount(const size_t& count)
+            {
+                _vertexCount = count;
+                return *this;
+            }
+
+            ScalarDrawable& setRange(const double& min, const double& max)
+            {
+                _range = Vector2(min, max);
+                return *this;
+            }
+
+            // Upload only the scalar attribute (float data is uploaded straight from the given memory)
+            virtual ScalarDrawable& updateField(const Eigen::Ref<const Eigen::VectorXf>& field)
+            {
+                // A shorter buffer would make the GPU read past the end of the attribute
+                if (size_t(field.size()) != _vertexCount) {
+                    Warning{} << "Expected a field of" << _vertexCount << "values, got" << field.size();
+                    return *this;
+                }
+
+                const Containers::ArrayView<const Float> values{field.data(), size_t(field.size())};
+
+                // Same size -> update in place, otherwise (re)allocate the storage
+                if (_valueCount == values.size())
+                    _scalarBuffer.setSubData(0, values);
+                else {
+                    _scalarBuffer.setData(values, GL::BufferUsage::DynamicDraw);
+                    _valueCount = values.size();
+                }
+
+                return *this;
+            }
+
+            // Double precision field (converted in a single pass)
+            ScalarDrawable& updateField(const Eigen::Ref<const Eigen::VectorXd>& field)
+            {
+                _values = field.cast<float>();
+                return updateField(Eigen::Ref<const Eigen::VectorXf>(_values));
+            }
+
+        protected:
+            // Shaders
+            shaders::ScalarColorGL<N>& _shader;
+
+            // Colormap texture
+            GL::Texture2D* _colormap = nullptr;
+
+            // Scalar range
+            Vector2 _range{-1.0f, 1.0f};
+
+        private:
+            void draw(const std::conditional_t<N == 3, Matrix4, Matrix3>& transformationMatrix, SceneGraph::Camera<N, Float>& camera) override
+            {
+                const auto transformation = transformationMatrix * AbstractDrawable<N>::_priorTransformation;
+
+                _shader
+                    .setTransformationProjectionMatrix(camera.projectionMatrix() * transformation)
+                    .setRange(_range.x(), _range.y())
+                    .bindColormapTexture(*_colormap);
+
+                AbstractDrawable<N>::drawMesh(_shader, transformation, camera);
+            }
+
+            // Scalars (staging vector for double precision fields, GPU buffer and number of values currently allocated)
+            Eigen::VectorXf _values;
+            GL::Buffer _scalarBuffer;
+            size_t _valueCount = 0, _vertexCount = 0;
+        };
+
+    } // namespace drawables
+} // namespace graphics_lib
+
+#endif // GRAPHICSLIB_SCALAR_DRAWABLE_HPP
@@ -0,0 +1,169 @@
+/*
+    This file is part of graphics-lib.
+
+    Copyright (c) 2020, 2021, 2022 Bernardo Fichera <bernardo.fichera@gmail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef GRAPHICSLIB_STREAM_DRAWABLE_HPP
+#define GRAPHICSLIB_STREAM_DRAWABLE_HPP
+
+#include "graphics_lib/drawbles/AbstractDrawable.hpp"
+#include <Eigen/Core>
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/Shaders/FlatGL.h>
+
+namespace graphics_lib {
+    namespace drawables {
+        // Line strip backed by a fixed size GPU ring buffer; appending never reallocates
+        template <size_t N = 3>
+        class StreamDrawable : public AbstractDrawable<N> {
+        public:
+            explicit StreamDrawable(SceneGraph::Object<std::conditional_t<N == 3, SceneGraph::MatrixTransformation3D, SceneGraph::MatrixTransformation2D>>& object, SceneGraph::DrawableGroup<N, Float>& group, Shaders::FlatGL<N>& shader, const size_t& capacity)
+                : AbstractDrawable<N>(object, group),
+                  _shader(shader),
+                  _capacity(std::max(capacity, MinimumCapacity)),
+                  _times{Containers::NoInit, _capacity}
+            {
+                // Empty rings are rejected (the ring index is taken modulo the capacity)
+                if (capacity < MinimumCapacity)
+                    Warning{} << "Stream capacity" << capacity << "too small, using" << MinimumCapacity;
+
+                // One extra slot (copy of the first one) keeps the strip connected across the wrap
+                _buffer.setData({nullptr, (_capacity + 1) * sizeof(std::conditional_t<N == 3, Vector3, Vector2>)}, GL::BufferUsage::DynamicDraw);
+
+                AbstractDrawable<N>::_mesh.setPrimitive(MeshPrimitive::LineStrip)
+                    .addVertexBuffer(_buffer, 0, typename Shaders::FlatGL<N>::Position{});
+            }
+
+            StreamDrawable& setColor(const Color4& color)
+            {
+                _color = color;
+                return *this;
+            }
+
+            // Draw only the samples within the last "window" time units (0 to draw all the stored samples)
+            StreamDrawable& setWindow(const double& window)
+            {
+                _window = window;
+                return *this;
+            }
+
+            // Append points (and optionally their time stamps, sample index is used otherwise)
+            StreamDrawable& append(const Eigen::Matrix<double, Eigen::Dynamic, N>& points, const Eigen::VectorXd& times = Eigen::VectorXd())
+            {
+                if (times.size() && times.size() != points.rows()) {
+                    Warning{} << "Expected" << points.rows() << "time stamps, got" << times.size();
+                    return *this;
+                }
+
+                // Only the last capacity points can be stored
+                const size_t count = points.rows(), skip = count > _capacity ? count - _capacity : 0;
+
+                Eigen::Matrix<float, Eigen::Dynamic, N, Eigen::RowMajor> data = points.bottomRows(count - skip).template cast<float>();
+
+                // Bounds only grow (conservative for culling, old points may have left the ring)
+                if (data.rows()) {
+                    Eigen::Matrix<float, 1, N> min = data.colwise().minCoeff(), max = data.colwise().maxCoeff();
+                    Math::Range<N, Float> box{Math::Vector<N, Float>::from(min.data()), Math::Vector<N, Float>::from(max.data())};
+                    AbstractDrawable<N>::setBoundingBox(AbstractDrawable<N>::_boundingBox ? Math::join(*AbstractDrawable<N>::_boundingBox, box) : box);
+                }
+
+                for (size_t written = 0; written < size_t(data.rows());) {
+                    const size_t chunk = std::min(size_t(data.rows()) - written, _capacity - _head);
+
+                    _buffer.setSubData(_head * N * sizeof(Float), Containers::ArrayView<const Float>{data.data() + written * N, chunk * N});
+
+                    if (!_head)
+                        _buffer.setSubData(_capacity * N * sizeof(Float), Containers::ArrayView<const Float>{data.data() + written * N, N});
+
+                    for (size_t i = 0; i < chunk; i++)
+                        _times[_head + i] = times.size() ? times(skip + written + i) : double(_samples + skip + written + i);
+
+                    _head = (_head + chunk) % _capacity;
+                    written += chunk;
+                }
+
+                _size = std::min(_size + count, _capacity);
+                _samples += count;
+
+                return *this;
+            }
+
+        private:
+            void draw(const std::conditional_t<N == 3, Matrix4, Matrix3>& transformationMatrix, SceneGraph::Camera<N, Float>& camera) override
+            {
+                if (_size < 2)
+                    return;
+
+                // Oldest stored sample and first sample within the time window (binary search over the ring)
+                const size_t oldest = (_head + _capacity - _size) % _capacity;
+                size_t first = 0;
+
+                if (_window > 0) {
+                    const double start = _times[(_head + _capacity - 1) % _capacity] - _window;
+                    size_t last = _size - 1;
+
+                    while (first < last) {
+                        const size_t middle = (first + last) / 2;
+                        if (_times[(oldest + middle) % _capacity] < start)
+                            first = middle + 1;
+                        else
+                            last = middle;
+                    }
+                }
+
+                const size_t begin = (oldest + first) % _capacity, count = _size - first;
+
+                const Containers::Optional<Color4> color = AbstractDrawable<N>::overrideColor();
+
+                _shader
+                    .setColor(color ? *color : _color)
+                    .setTransformationProjectionMatrix(camera.projectionMatrix() * transformationMatrix * AbstractDrawable<N>::_priorTransformation);
+
+                // Contiguous range or two ranges joined by the extra slot
+                if (begin + count <= _capacity)
+                    _shader.draw(AbstractDrawable<N>::_mesh.setBaseVertex(begin).setCount(count));
+                else {
+                    _shader.draw(AbstractDrawable<N>::_mesh.setBaseVertex(begin).setCount(_capacity - begin + 1));
+                    _shader.draw(AbstractDrawable<N>::_mesh.setBaseVertex(0).setCount(count - (_capacity - begin)));
+                }
+            }
+
+            // Shaders
+            Shaders::FlatGL<N>& _shader;
+
+            // Color
+            Color4 _color;
+
+            // Ring buffer (capacity, write position, stored samples and total appended samples), at least a segment
+            static constexpr size_t MinimumCapacity = 2;
+            GL::Buffer _buffer;
+            size_t _capacity, _head = 0, _size = 0, _samples = 0;
+
+            // Time stamps (CPU side only) and time window
+            Containers::Array<double> _times;
+            double _window = 0;
+        };
+
+    } // namespace drawables
+} // namespace graphics_lib
+
+#endif // GRAPHICSLIB_STREAM_DRAWABLE_HPP
@@ -26,7 +26,9 @@
 #define GRAPHICSLIB_TEXTURE_DRAWABLE_HPP
 
 #include "graphics_lib/drawbles/AbstractDrawable.hpp"
+#include "graphics_lib/drawbles/UniformQueue.hpp"
 #include <Magnum/GL/Texture.h>
+#include <Magnum/Resource.h>
 #include <Magnum/Shaders/Phong.h>
 
 namespace graphics_lib {
@@ -41,12 +43,79 @@ namespace graphics_lib {
             TextureDrawable& setTexture(GL::Texture2D& texture)
             {
                 _texture = std::move(texture);
+                _sharedTexture = Resource<GL::Texture2D>{};
                 return *this;
             }
 
+            // Reference a texture shared with other drawables (not owned)
+            TextureDrawable& setTexture(const Resource<GL::Texture2D>& texture)
+            {
+                _sharedTexture = texture;
+                return *this;
+            }
+
+            SortKey sortKey() override
+            {
+                return SortKey{reinterpret_cast<std::uintptr_t>(&_shader), reinterpret_cast<std::uintptr_t>(&texture()), 0, reinterpret_cast<std::uintptr_t>(&AbstractDrawable<N>::mesh())};
+            }
+
+            void drawQueued(const std::conditional_t<N == 3, Matrix4, Matrix3>& transformationMatrix, SceneGraph::Camera<N, Float>& camera, RenderState& state) override
+            {
+                auto transformation = transformationMatrix * AbstractDrawable<N>::_priorTransformation;
+
+                // Projection is the same for the whole queue
+                if (state.shader != &_shader) {
+                    state = RenderState{};
+                    state.shader = &_shader;
+                    _shader.setProjectionMatrix(camera.projectionMatrix());
+                }
+
+                // Drawables sharing the texture are sorted next to each other
+                if (state.texture != &texture()) {
+                    _shader.bindDiffuseTexture(texture());
+                    state.texture = &texture();
+                }
+
+                // Override color tints the texture
+                const Color4 tint = tintColor();
+                if (!state.color || *state.color != tint) {
+                    _shader.setDiffuseColor(tint);
+                    state.color = tint;
+                }
+
+                _shader
+                    .setTransformationMatrix(transformation)
+                    .setNormalMatrix(transformation.normalMatrix());
+
+                AbstractDrawable<N>::drawMesh(_shader, transformation, camera);
+            }
+
+            bool enqueue(const std::conditional_t<N == 3, Matrix4, Matrix3>& transformationMatrix, UniformQueue& queue) override
+            {
+                if constexpr (N == 3) {
+                    Shaders::PhongMaterialUniform material = queue.material();
+                    material.setDiffuseColor(tintColor());
+
+                    queue.add(*this, transformationMatrix * AbstractDrawable<N>::_priorTransformation, material, &texture());
+                    return true;
+                }
+                else
+                    return false;
+            }
+
         protected:
-            // Texture
+            // Texture (owned) and shared texture (takes precedence if set)
             GL::Texture2D _texture;
+            Resource<GL::Texture2D> _sharedTexture;
+
+            GL::Texture2D& texture() { return _sharedTexture ? *_sharedTexture : _texture; }
+
+            // Texture multiplier (white unless overridden)
+            Color4 tintColor() const
+            {
+                Containers::Optional<Color4> color = AbstractDrawable<N>::overrideColor();
+                return color ? *color : Color4{1.0f};
+            }
 
         private:
             void draw(const std::conditional_t<N == 3, Matrix4, Matrix3>& transformationMatrix, SceneGraph::Camera<N, Float>& camera) override
@@ -60,8 +129,10 @@ namespace graphics_lib {
                     .setTransformationMatrix(transformation)
                     .setNormalMatrix(transformation.normalMatrix())
                     .setProjectionMatrix(camera.projectionMatrix())
-                    .bindDiffuseTexture(_texture)
-                    .draw(AbstractDrawable<N>::_mesh);
+                    .setDiffuseColor(tintColor())
+                    .bindDiffuseTexture(texture());
+
+                AbstractDrawable<N>::drawMesh(_shader, transformation, camera);
             }
 
             // Shaders
@@ -0,0 +1,198 @@
+/*
+    This file is part of graphics-lib.
+
+    Copyright (c) 2020, 2021, 2022 Bernardo Fichera <bernardo.fichera@gmail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef GRAPHICSLIB_TRAJECTORY_DRAWABLE_HPP
+#define GRAPHICSLIB_TRAJECTORY_DRAWABLE_HPP
+
+#include "graphics_lib/drawbles/AbstractDrawable.hpp"
+#include "graphics_lib/tools/quantize.hpp"
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/Pair.h>
+#include <Eigen/Core>
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/Shaders/FlatGL.h>
+
+namespace graphics_lib {
+    namespace drawables {
+        // Non-indexed line strip with a decimation hierarchy; the level is chosen from the projected segment length
+        template <size_t N = 3>
+        class TrajectoryDrawable : public AbstractDrawable<N> {
+        public:
+            explicit TrajectoryDrawable(SceneGraph::Object<std::conditional_t<N == 3, SceneGraph::MatrixTransformation3D, SceneGraph::MatrixTransformation2D>>& object, SceneGraph::DrawableGroup<N, Float>& group, Shaders::FlatGL<N>& shader)
+                : AbstractDrawable<N>(object, group),
+                  _shader(shader) {}
+
+            TrajectoryDrawable& setColor(const Color4& color)
+            {
+                _color = color;
+                return *this;
+            }
+
+            // Upload trajectory and its coarser levels (every level keeps one point out of two of the previous one plus the last point)
+            // Contiguous row-major points are uploaded straight from the given memory, unless quantized to 16-bit (3D only)
+            TrajectoryDrawable& setTrajectory(const Eigen::Ref<const Eigen::Matrix<float, Eigen::Dynamic, N, Eigen::RowMajor>>& points, const bool& quantize = false)
+            {
+                const size_t rows = points.rows();
+
+                // Strided rows (e.g. a block of a wider matrix) are copied once
+                Eigen::Matrix<float, Eigen::Dynamic, N, Eigen::RowMajor> copy;
+                const Float* data = points.data();
+                if (rows > 1 && points.outerStride() != N) {
+                    copy = points;
+                    data = copy.data();
+                }
+
+                const Containers::ArrayView<const VectorType> full{reinterpret_cast<const VectorType*>(data), rows};
+
+                // Coarser levels (back to back after the full resolution)
+                Containers::Array<VectorType> coarse;
+                arrayReserve(coarse, rows + 64);
+
+                _levels = {};
+                arrayAppend(_levels, Containers::InPlaceInit, 0u, UnsignedInt(rows));
+
+                auto point = [&](const UnsignedInt& i) { return i < rows ? full[i] : coarse[i - rows]; };
+
+                while (_levels.back().second() > MinimumPoints) {
+                    const UnsignedInt offset = _levels.back().first(), count = _levels.back().second(), start = rows + coarse.size();
+
+                    for (UnsignedInt i = 0; i < count; i += 2)
+                        arrayAppend(coarse, point(offset + i));
+
+                    if ((count - 1) % 2)
+                        arrayAppend(coarse, point(offset + count - 1));
+
+                    arrayAppend(_levels, Containers::InPlaceInit, start, UnsignedInt(rows + coarse.size()) - start);
+                }
+
+                // Average segment length and center (used for level selection)
+                if (rows > 1) {
+                    _segment = (points.bottomRows(rows - 1) - points.topRows(rows - 1)).rowwise().norm().sum() / (rows - 1);
+                    Eigen::Matrix<float, 1, N> center = 0.5f * (points.colwise().minCoeff() + points.colwise().maxCoeff());
+                    _center = VectorType(Math::Vector<N, Float>::from(center.data()));
+                }
+
+                if (rows) {
+                    Eigen::Matrix<float, 1, N> min = points.colwise().minCoeff(), max = points.colwise().maxCoeff();
+                    AbstractDrawable<N>::setBoundingBox({VectorType(Math::Vector<N, Float>::from(min.data())), VectorType(Math::Vector<N, Float>::from(max.data()))});
+                }
+
+                // Positions inside the bounding box (dequantized right before the projection)
+                _dequantization = {};
+                if constexpr (N == 3) {
+                    if (quantize && rows) {
+                        const Range3D range = tools::quantizationRange(full);
+
+                        Containers::Array<Vector4us> quantized{Containers::NoInit, rows + coarse.size()};
+                        tools::quantizePositions(full, range, quantized.prefix(rows));
+                        tools::quantizePositions(Containers::arrayView(coarse), range, quantized.slice(rows, quantized.size()));
+                        _dequantization = tools::dequantization(range);
+
+                        _buffer.setData(quantized, GL::BufferUsage::StaticDraw);
+
+                        AbstractDrawable<N>::_mesh.setPrimitive(MeshPrimitive::LineStrip)
+                            .addVertexBuffer(_buffer, 0, typename Shaders::FlatGL<N>::Position{Shaders::FlatGL<N>::Position::DataType::UnsignedShort, Shaders::FlatGL<N>::Position::DataOption::Normalized}, 2);
+
+                        return *this;
+                    }
+                }
+
+                // Storage allocated once, then filled from the two sources
+                _buffer.setData({nullptr, (rows + coarse.size()) * sizeof(VectorType)}, GL::BufferUsage::StaticDraw);
+                _buffer.setSubData(0, full);
+                _buffer.setSubData(rows * sizeof(VectorType), coarse);
+
+                AbstractDrawable<N>::_mesh.setPrimitive(MeshPrimitive::LineStrip)
+                    .addVertexBuffer(_buffer, 0, typename Shaders::FlatGL<N>::Position{});
+
+                return *this;
+            }
+
+            // Double precision trajectory (converted in a single pass)
+            TrajectoryDrawable& setTrajectory(const Eigen::Ref<const Eigen::Matrix<double, Eigen::Dynamic, N>>& trajectory, const bool& quantize = false)
+            {
+                const Eigen::Matrix<float, Eigen::Dynamic, N, Eigen::RowMajor> points = trajectory.template cast<float>();
+                return setTrajectory(Eigen::Ref<const Eigen::Matrix<float, Eigen::Dynamic, N, Eigen::RowMajor>>(points), quantize);
+            }
+
+            size_t levelCount() const { return _levels.size(); }
+
+        private:
+            using VectorType = std::conditional_t<N == 3, Vector3, Vector2>;
+
+            // Coarsest level size and maximum on-screen segment length (pixels)
+            static constexpr UnsignedInt MinimumPoints = 64;
+            static constexpr Float PixelThreshold = 2.0f;
+
+            void draw(const std::conditional_t<N == 3, Matrix4, Matrix3>& transformationMatrix, SceneGraph::Camera<N, Float>& camera) override
+            {
+                if (_levels.isEmpty() || _levels.front().second() < 2)
+                    return;
+
+                auto transformation = transformationMatrix * AbstractDrawable<N>::_priorTransformation;
+
+                // Level such that the decimated segments stay below the pixel threshold
+                size_t level = 0;
+
+                if constexpr (N == 3) {
+                    const Float depth = -transformation.transformPoint(_center).z();
+
+                    if (depth > 0.0f) {
+                        const Float pixels = _segment * transformation.scaling().max() * camera.projectionMatrix()[1][1] * camera.viewport().y() / (2.0f * depth);
+
+                        if (pixels > 0.0f && pixels < PixelThreshold)
+                            level = std::min(size_t(Math::log2(UnsignedInt(PixelThreshold / pixels))), _levels.size() - 1);
+                    }
+                }
+
+                const Containers::Optional<Color4> color = AbstractDrawable<N>::overrideColor();
+
+                _shader
+                    .setColor(color ? *color : _color)
+                    .setTransformationProjectionMatrix(camera.projectionMatrix() * transformation * _dequantization)
+                    .draw(AbstractDrawable<N>::_mesh.setBaseVertex(_levels[level].first()).setCount(_levels[level].second()));
+            }
+
+            // Shaders
+            Shaders::FlatGL<N>& _shader;
+
+            // Color
+            Color4 _color;
+
+            // Positions of all the levels (back to back) and [offset, count] of each level
+            GL::Buffer _buffer;
+            Containers::Array<Containers::Pair<UnsignedInt, UnsignedInt>> _levels;
+
+            // Quantized positions to trajectory coordinates (identity if not quantized)
+            std::conditional_t<N == 3, Matrix4, Matrix3> _dequantization;
+
+            // Average full resolution segment length and center of the bounding box
+            Float _segment = 0.0f;
+            VectorType _center;
+        };
+
+    } // namespace drawables
+} // namespace graphics_lib
+
+#endif // GRAPHICSLIB_TRAJECTORY_DRAWABLE_HPP
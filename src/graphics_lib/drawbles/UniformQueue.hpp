@@ -0,0 +1,134 @@
+/*
+    This file is part of graphics-lib.
+
+    Copyright (c) 2020, 2021, 2022 Bernardo Fichera <bernardo.fichera@gmail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+#ifndef GRAPHICSLIB_UNIFORM_QUEUE_HPP
+#define GRAPHICSLIB_UNIFORM_QUEUE_HPP
+
+#include "graphics_lib/drawbles/AbstractDrawable.hpp"
+#include <Corrade/Containers/GrowableArray.h>
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/SceneGraph/Camera.h>
+#include <Magnum/Shaders/Generic.h>
+#include <Magnum/Shaders/Phong.h>
+
+namespace graphics_lib {
+    namespace drawables {
+        // Render queue drawn through uniform buffers: per-draw transformations, normal matrices and materials
+        // are uploaded once per frame, each draw then only selects its slot (3D Phong shading only)
+        class UniformQueue {
+        public:
+            // Draws per bound range of the uniform buffers (keeps every range below the 16 kB guaranteed by GL)
+            static constexpr UnsignedInt DrawCount = 128;
+
+            explicit UniformQueue(const Shaders::PhongGL::Flags& flags, const UnsignedInt& lightCount, const Shaders::PhongMaterialUniform& material)
+                : _shader{Shaders::PhongGL::Configuration{}
+                              .setFlags(flags | Shaders::PhongGL::Flag::UniformBuffers)
+                              .setLightCount(lightCount)
+                              .setMaterialCount(DrawCount)
+                              .setDrawCount(DrawCount)},
+                  _material(material)
+            {
+                // Default lights of the non uniform buffer shaders
+                const Containers::Array<Shaders::PhongLightUniform> lights{lightCount};
+                _lightBuffer.setData(lights, GL::BufferUsage::StaticDraw);
+            }
+
+            // Material of the draws not setting their own
+            const Shaders::PhongMaterialUniform& material() const { return _material; }
+
+            // Collect a draw (texture is nullptr for untextured shaders)
+            UniformQueue& add(AbstractDrawable<3>& drawable, const Matrix4& transformation, const Shaders::PhongMaterialUniform& material, GL::Texture2D* texture = nullptr)
+            {
+                arrayAppend(_draws, Draw{&drawable, transformation, material, texture});
+                return *this;
+            }
+
+            // Upload the collected draws and draw them (in insertion order)
+            void submit(SceneGraph::Camera3D& camera)
+            {
+                if (_draws.isEmpty())
+                    return;
+
+                // Buffers padded to whole ranges
+                const size_t ranges = (_draws.size() + DrawCount - 1) / DrawCount, count = ranges * DrawCount;
+
+                Containers::Array<Shaders::TransformationUniform3D> transformations{count};
+                Containers::Array<Shaders::PhongDrawUniform> draws{count};
+                Containers::Array<Shaders::PhongMaterialUniform> materials{count};
+
+                for (size_t i = 0; i < _draws.size(); ++i) {
+                    transformations[i].setTransformationMatrix(_draws[i].transformation);
+                    draws[i].setNormalMatrix(_draws[i].transformation.normalMatrix()).setMaterialId(i % DrawCount);
+                    materials[i] = _draws[i].material;
+                }
+
+                _projectionBuffer.setData({Shaders::ProjectionUniform3D{}.setProjectionMatrix(camera.projectionMatrix())}, GL::BufferUsage::DynamicDraw);
+                _transformationBuffer.setData(transformations, GL::BufferUsage::DynamicDraw);
+                _drawBuffer.setData(draws, GL::BufferUsage::DynamicDraw);
+                _materialBuffer.setData(materials, GL::BufferUsage::DynamicDraw);
+
+                _shader.bindProjectionBuffer(_projectionBuffer).bindLightBuffer(_lightBuffer);
+
+                GL::Texture2D* texture = nullptr;
+                for (size_t range = 0; range < ranges; ++range) {
+                    _shader
+                        .bindTransformationBuffer(_transformationBuffer, range * DrawCount * sizeof(Shaders::TransformationUniform3D), DrawCount * sizeof(Shaders::TransformationUniform3D))
+                        .bindDrawBuffer(_drawBuffer, range * DrawCount * sizeof(Shaders::PhongDrawUniform), DrawCount * sizeof(Shaders::PhongDrawUniform))
+                        .bindMaterialBuffer(_materialBuffer, range * DrawCount * sizeof(Shaders::PhongMaterialUniform), DrawCount * sizeof(Shaders::PhongMaterialUniform));
+
+                    for (size_t i = range * DrawCount; i < Math::min(_draws.size(), (range + 1) * DrawCount); ++i) {
+                        // Draws sharing a texture are sorted next to each other
+                        if (_draws[i].texture && _draws[i].texture != texture) {
+                            texture = _draws[i].texture;
+                            _shader.bindDiffuseTexture(*texture);
+                        }
+
+                        _shader.setDrawOffset(i % DrawCount);
+                        _draws[i].drawable->drawMesh(_shader, _draws[i].transformation, camera);
+                    }
+                }
+
+                // Storage kept for the next frame
+                arrayResize(_draws, Containers::NoInit, 0);
+            }
+
+        protected:
+            struct Draw {
+                AbstractDrawable<3>* drawable;
+                Matrix4 transformation;
+                Shaders::PhongMaterialUniform material;
+                GL::Texture2D* texture;
+            };
+
+            Shaders::PhongGL _shader;
+            Shaders::PhongMaterialUniform _material;
+
+            Containers::Array<Draw> _draws;
+            GL::Buffer _projectionBuffer, _transformationBuffer, _drawBuffer, _materialBuffer, _lightBuffer;
+        };
+    } // namespace drawables
+} // namespace graphics_lib
+
+#endif // GRAPHICSLIB_UNIFORM_QUEUE_HPP
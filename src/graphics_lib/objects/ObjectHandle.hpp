@@ -25,87 +25,359 @@
 #ifndef GRAPHICSLIB_OBJECT_HANDLE_HPP
 #define GRAPHICSLIB_OBJECT_HANDLE_HPP
 
+#include <atomic>
+#include <utility>
+
+#include <Corrade/Containers/Pointer.h>
 #include <Magnum/GL/Mesh.h>
+#include <Magnum/SceneGraph/AbstractFeature.h>
 #include <Magnum/SceneGraph/Object.hpp>
 
 #include "graphics_lib/drawbles/ColorDrawable.hpp"
 #include "graphics_lib/drawbles/Drawables.h"
+#include "graphics_lib/drawbles/InstancedDrawable.hpp"
 #include "graphics_lib/drawbles/PhongDrawable.hpp"
+#include "graphics_lib/drawbles/PointCloudDrawable.hpp"
+#include "graphics_lib/drawbles/ScalarDrawable.hpp"
+#include "graphics_lib/drawbles/StreamDrawable.hpp"
 #include "graphics_lib/drawbles/TextureDrawable.hpp"
+#include "graphics_lib/drawbles/TrajectoryDrawable.hpp"
 
 namespace graphics_lib {
     namespace objects {
         template <size_t N = 3>
-        class ObjectHandle : public SceneGraph::Object<typename std::conditional<N == 3, SceneGraph::MatrixTransformation3D, SceneGraph::MatrixTransformation2D>::type> {
+        class ObjectHandle : public SceneGraph::Object<typename std::conditional<N == 3, SceneGraph::MatrixTransformation3D, SceneGraph::MatrixTransformation2D>::type>, public drawables::Overridable {
         public:
+            using Base = SceneGraph::Object<typename std::conditional<N == 3, SceneGraph::MatrixTransformation3D, SceneGraph::MatrixTransformation2D>::type>;
+
             ObjectHandle(SceneGraph::Object<typename std::conditional<N == 3, SceneGraph::MatrixTransformation3D, SceneGraph::MatrixTransformation2D>::type>* object, std::unordered_map<ObjectHandle<N>*, Containers::Pointer<drawables::AbstractDrawable<N>>>& drawableObj)
                 : SceneGraph::Object<typename std::conditional<N == 3, SceneGraph::MatrixTransformation3D, SceneGraph::MatrixTransformation2D>::type>{object},
-                  _drawableObjects(drawableObj) {}
+                  _drawableObjects(drawableObj)
+            {
+                // Share the redraw flag and the overrides of the parent
+                if (auto parent = dynamic_cast<ObjectHandle<N>*>(object)) {
+                    _changed = parent->_changed;
+                    _override = parent->_override;
+                }
+
+                // Owned (and deleted) by the object
+                new RedrawFeature{*this};
+
+                markChanged();
+            }
+
+            // Flag raised on every change of this object (and the objects created as its children)
+            ObjectHandle<N>& setRedrawFlag(std::atomic<bool>* flag)
+            {
+                _changed = flag;
+                return markChanged();
+            }
+
+            // Schedule a new frame (call it after changing drawables directly)
+            ObjectHandle<N>& markChanged()
+            {
+                if (_changed)
+                    *_changed = true;
+
+                return *this;
+            }
 
             ObjectHandle<N>& setMesh(GL::Mesh& mesh)
             {
-                if (_drawableObjects.find(this) == _drawableObjects.end()) {
+                markChanged();
+
+                auto it = _drawableObjects.find(this);
+                if (it == _drawableObjects.end()) {
                     for (auto& child : this->children())
                         static_cast<ObjectHandle<N>&>(child).setMesh(mesh);
                 }
                 else
-                    _drawableObjects[this]->setMesh(mesh);
+                    it->second->setMesh(mesh);
 
                 return *this;
             }
 
-            ObjectHandle<N>& setTexture(GL::Texture2D& texture)
+            // Texture shared by all the textured drawables of the subtree (see Graphics::addTexture())
+            ObjectHandle<N>& setTexture(const Resource<GL::Texture2D>& texture)
             {
-                if (_drawableObjects.find(this) == _drawableObjects.end()) {
+                markChanged();
+
+                auto it = _drawableObjects.find(this);
+                if (it == _drawableObjects.end()) {
                     for (auto& child : this->children())
                         static_cast<ObjectHandle<N>&>(child).setTexture(texture);
                 }
-                else
-                    static_cast<drawables::TextureDrawable3D*>(_drawableObjects[this].get())->setTexture(texture);
+                else if (auto drawable = dynamic_cast<drawables::TextureDrawable<N>*>(it->second.get()))
+                    drawable->setTexture(texture);
 
                 return *this;
             }
 
-            ObjectHandle<N>& setMaterial(Trade::PhongMaterialData& material)
+            // Material shared by all the Phong drawables of the subtree
+            ObjectHandle<N>& setMaterial(const Resource<Trade::PhongMaterialData>& material)
             {
-                if (_drawableObjects.find(this) == _drawableObjects.end()) {
+                markChanged();
+
+                auto it = _drawableObjects.find(this);
+                if (it == _drawableObjects.end()) {
                     for (auto& child : this->children())
                         static_cast<ObjectHandle<N>&>(child).setMaterial(material);
                 }
-                else
-                    static_cast<drawables::PhongDrawable3D*>(_drawableObjects[this].get())->setMaterial(material);
+                else if (auto drawable = dynamic_cast<drawables::PhongDrawable<N>*>(it->second.get()))
+                    drawable->setMaterial(material);
 
                 return *this;
             }
 
             ObjectHandle<N>& setColor(const Color4& color)
             {
-                if (_drawableObjects.find(this) == _drawableObjects.end()) {
+                markChanged();
+
+                auto it = _drawableObjects.find(this);
+                if (it == _drawableObjects.end()) {
                     for (auto& child : this->children())
                         static_cast<ObjectHandle<N>&>(child).setColor(color);
                 }
-                else
-                    static_cast<drawables::PhongDrawable3D*>(_drawableObjects[this].get())->setColor(color);
+                else if (auto drawable = dynamic_cast<drawables::PhongDrawable<N>*>(it->second.get()))
+                    drawable->setColor(color);
 
                 return *this;
             }
 
             ObjectHandle<N>& addPriorTransformation(const std::conditional_t<N == 3, Matrix4, Matrix3>& transformation)
             {
-                if (_drawableObjects.find(this) == _drawableObjects.end()) {
+                markChanged();
+
+                auto it = _drawableObjects.find(this);
+                if (it == _drawableObjects.end()) {
                     for (auto& child : this->children())
                         static_cast<ObjectHandle<N>&>(child).addPriorTransformation(transformation);
                 }
                 else
-                    _drawableObjects[this]->addPriorTransformation(transformation);
+                    it->second->addPriorTransformation(transformation);
+
+                return *this;
+            }
+
+            ObjectHandle<N>& updateField(const Eigen::VectorXd& field)
+            {
+                markChanged();
+
+                auto it = _drawableObjects.find(this);
+                if (it == _drawableObjects.end()) {
+                    for (auto& child : this->children())
+                        static_cast<ObjectHandle<N>&>(child).updateField(field);
+                }
+                else if (auto drawable = dynamic_cast<drawables::ScalarDrawable<N>*>(it->second.get()))
+                    drawable->updateField(field);
 
                 return *this;
             }
 
+            ObjectHandle<N>& updateField(const Eigen::VectorXd& field, const double& min, const double& max)
+            {
+                return setRange(min, max).updateField(field);
+            }
+
+            ObjectHandle<N>& setRange(const double& min, const double& max)
+            {
+                markChanged();
+
+                auto it = _drawableObjects.find(this);
+                if (it == _drawableObjects.end()) {
+                    for (auto& child : this->children())
+                        static_cast<ObjectHandle<N>&>(child).setRange(min, max);
+                }
+                else if (auto drawable = dynamic_cast<drawables::ScalarDrawable<N>*>(it->second.get()))
+                    drawable->setRange(min, max);
+
+                return *this;
+            }
+
+            ObjectHandle<N>& setColormap(GL::Texture2D& colormap)
+            {
+                markChanged();
+
+                auto it = _drawableObjects.find(this);
+                if (it == _drawableObjects.end()) {
+                    for (auto& child : this->children())
+                        static_cast<ObjectHandle<N>&>(child).setColormap(colormap);
+                }
+                else if (auto drawable = dynamic_cast<drawables::ScalarDrawable<N>*>(it->second.get()))
+                    drawable->setColormap(colormap);
+
+                return *this;
+            }
+
+            ObjectHandle<N>& append(const Eigen::Matrix<double, Eigen::Dynamic, N>& points, const Eigen::VectorXd& times = Eigen::VectorXd())
+            {
+                markChanged();
+
+                auto it = _drawableObjects.find(this);
+                if (it == _drawableObjects.end()) {
+                    for (auto& child : this->children())
+                        static_cast<ObjectHandle<N>&>(child).append(points, times);
+                }
+                else if (auto drawable = dynamic_cast<drawables::StreamDrawable<N>*>(it->second.get()))
+                    drawable->append(points, times);
+
+                return *this;
+            }
+
+            ObjectHandle<N>& setWindow(const double& window)
+            {
+                markChanged();
+
+                auto it = _drawableObjects.find(this);
+                if (it == _drawableObjects.end()) {
+                    for (auto& child : this->children())
+                        static_cast<ObjectHandle<N>&>(child).setWindow(window);
+                }
+                else if (auto drawable = dynamic_cast<drawables::StreamDrawable<N>*>(it->second.get()))
+                    drawable->setWindow(window);
+
+                return *this;
+            }
+
+            ObjectHandle<N>& updateInstances(const Eigen::Matrix<double, Eigen::Dynamic, 3>& positions, const Eigen::Matrix<double, Eigen::Dynamic, 3>& colors = Eigen::Matrix<double, Eigen::Dynamic, 3>(), const double& scale = 1)
+            {
+                markChanged();
+
+                auto it = _drawableObjects.find(this);
+                if (it == _drawableObjects.end()) {
+                    for (auto& child : this->children())
+                        static_cast<ObjectHandle<N>&>(child).updateInstances(positions, colors, scale);
+                }
+                else if (auto drawable = dynamic_cast<drawables::InstancedDrawable<N>*>(it->second.get()))
+                    drawable->setInstances(positions, colors, scale);
+
+                return *this;
+            }
+
+            ObjectHandle<N>& setPointBudget(const size_t& budget)
+            {
+                markChanged();
+
+                auto it = _drawableObjects.find(this);
+                if (it == _drawableObjects.end()) {
+                    for (auto& child : this->children())
+                        static_cast<ObjectHandle<N>&>(child).setPointBudget(budget);
+                }
+                else if (auto drawable = dynamic_cast<drawables::PointCloudDrawable<N>*>(it->second.get()))
+                    drawable->setPointBudget(budget);
+
+                return *this;
+            }
+
+            /* Subtree overrides (the first call binds the subtree once, later calls are O(1)) */
+
+            // Color of all the drawables in the subtree (highlighting)
+            ObjectHandle<N>& setOverrideColor(const Color4& color)
+            {
+                ownOverride().color = color;
+                return markChanged();
+            }
+
+            ObjectHandle<N>& clearOverrideColor()
+            {
+                if (_ownOverride)
+                    _ownOverride->color = Containers::NullOpt;
+
+                return markChanged();
+            }
+
+            // Show/hide all the drawables in the subtree
+            ObjectHandle<N>& setVisible(const bool& visible)
+            {
+                ownOverride().visible = visible;
+                return markChanged();
+            }
+
+            // Bounding box of the drawables in this subtree (in the frame of this object), empty if none is bounded
+            Containers::Optional<Math::Range<N, Float>> boundingBox()
+            {
+                Containers::Optional<Math::Range<N, Float>> box;
+
+                auto it = _drawableObjects.find(this);
+                if (it != _drawableObjects.end() && it->second->boundingBox())
+                    box = transformBox(*it->second->boundingBox(), it->second->priorTransformation());
+
+                for (auto& child : this->children()) {
+                    Containers::Optional<Math::Range<N, Float>> childBox = static_cast<ObjectHandle<N>&>(child).boundingBox();
+                    if (!childBox)
+                        continue;
+
+                    const Math::Range<N, Float> transformed = transformBox(*childBox, child.transformationMatrix());
+                    box = box ? Math::join(*box, transformed) : transformed;
+                }
+
+                return box;
+            }
+
             bool isDrawable() { return (_drawableObjects.find(this) == _drawableObjects.end()) ? false : true; }
 
         private:
             std::unordered_map<ObjectHandle<N>*, Containers::Pointer<drawables::AbstractDrawable<N>>>& _drawableObjects;
+
+            // Redraw flag (owned by the application)
+            std::atomic<bool>* _changed = nullptr;
+
+            // Raises the redraw flag whenever the scene graph marks the object dirty: every transformation change goes
+            // through Object::setDirty(), also when made through SceneGraph::Object (dirty objects are cleaned every frame)
+            class RedrawFeature : public SceneGraph::AbstractFeature<N, Float> {
+            public:
+                explicit RedrawFeature(ObjectHandle<N>& object) : SceneGraph::AbstractFeature<N, Float>{object}, _handle(object) {}
+
+            private:
+                void markDirty() override { _handle.markChanged(); }
+
+                ObjectHandle<N>& _handle;
+            };
+
+            // Override owned by this object
+            Containers::Pointer<drawables::Override> _ownOverride;
+
+            drawables::Override& ownOverride()
+            {
+                if (!_ownOverride) {
+                    _ownOverride.reset(new drawables::Override);
+                    _ownOverride->parent = _override;
+                    bindOverride(_override, _ownOverride.get());
+                }
+
+                return *_ownOverride;
+            }
+
+            // Replace the enclosing override in the subtree (nested overrides are re-parented, their subtree is left untouched)
+            void bindOverride(const drawables::Override* previous, const drawables::Override* current)
+            {
+                if (_override != previous) {
+                    if (_ownOverride && _ownOverride->parent == previous)
+                        _ownOverride->parent = current;
+                    return;
+                }
+
+                _override = current;
+                for (auto& child : this->children())
+                    static_cast<ObjectHandle<N>&>(child).bindOverride(previous, current);
+            }
+
+            // Axis-aligned box containing the transformed corners of the box
+            static Math::Range<N, Float> transformBox(const Math::Range<N, Float>& box, const std::conditional_t<N == 3, Matrix4, Matrix3>& transformation)
+            {
+                Containers::Optional<Math::Range<N, Float>> result;
+
+                for (UnsignedInt i = 0; i < (1u << N); ++i) {
+                    Math::Vector<N, Float> corner;
+                    for (UnsignedInt j = 0; j < N; ++j)
+                        corner[j] = (i >> j) & 1 ? box.max()[j] : box.min()[j];
+
+                    const auto point = transformation.transformPoint(corner);
+                    result = result ? Math::join(*result, Math::Range<N, Float>{point, point}) : Math::Range<N, Float>{point, point};
+                }
+
+                return *result;
+            }
         };
     } // namespace objects
 } // namespace graphics_lib
@@ -31,6 +31,8 @@ namespace graphics_lib {
         class ObjectHandle;
         typedef ObjectHandle<2> ObjectHandle2D;
         typedef ObjectHandle<3> ObjectHandle3D;
+
+        class PoseBatch;
     } // namespace objects
 } // namespace graphics_lib
 
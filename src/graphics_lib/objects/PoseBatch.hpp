@@ -0,0 +1,98 @@
+/*
+    This file is part of graphics-lib.
+
+    Copyright (c) 2020, 2021, 2022 Bernardo Fichera <bernardo.fichera@gmail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef GRAPHICSLIB_POSE_BATCH_HPP
+#define GRAPHICSLIB_POSE_BATCH_HPP
+
+#include <vector>
+
+#include <Eigen/Core>
+#include <Magnum/Math/Matrix4.h>
+#include <Magnum/Math/Quaternion.h>
+
+#include "graphics_lib/objects/ObjectHandle.hpp"
+
+namespace graphics_lib {
+    namespace objects {
+        // Fixed list of objects whose transformations are set all at once (one row per object)
+        class PoseBatch {
+        public:
+            explicit PoseBatch(const std::vector<ObjectHandle3D*>& handles) : _handles(handles) {}
+
+            size_t size() const { return _handles.size(); }
+
+            // Homogeneous transformations, each row is a 4x4 matrix in row-major order
+            PoseBatch& setTransformations(const Eigen::Ref<const Eigen::Matrix<double, Eigen::Dynamic, 16, Eigen::RowMajor>>& transformations)
+            {
+                if (size_t(transformations.rows()) != _handles.size()) {
+                    Warning{} << "Expected" << _handles.size() << "transformations, got" << transformations.rows();
+                    return *this;
+                }
+
+                // Single (vectorized) conversion for the whole batch
+                _matrices = transformations.cast<float>();
+
+                // Row-major rows read as column-major matrices are the transposed ones (rows of null handles are skipped)
+                for (size_t i = 0; i < _handles.size(); ++i)
+                    if (_handles[i])
+                        _handles[i]->setTransformation(Matrix4::from(_matrices.row(i).data()).transposed());
+
+                return *this;
+            }
+
+            // Positions and unit quaternions, each row is [x y z qx qy qz qw]
+            PoseBatch& setPoses(const Eigen::Ref<const Eigen::Matrix<double, Eigen::Dynamic, 7, Eigen::RowMajor>>& poses)
+            {
+                if (size_t(poses.rows()) != _handles.size()) {
+                    Warning{} << "Expected" << _handles.size() << "poses, got" << poses.rows();
+                    return *this;
+                }
+
+                // Single (vectorized) conversion for the whole batch
+                _poses = poses.cast<float>();
+
+                for (size_t i = 0; i < _handles.size(); ++i) {
+                    if (!_handles[i])
+                        continue;
+
+                    const Float* pose = _poses.row(i).data();
+                    const Quaternion rotation{Vector3::from(pose + 3), pose[6]};
+                    _handles[i]->setTransformation(Matrix4::from(rotation.toMatrix(), Vector3::from(pose)));
+                }
+
+                return *this;
+            }
+
+        protected:
+            // Objects of the batch (null entries keep the row layout, their rows are ignored)
+            std::vector<ObjectHandle3D*> _handles;
+
+            // Converted poses (kept to avoid reallocating every frame)
+            Eigen::Matrix<float, Eigen::Dynamic, 16, Eigen::RowMajor> _matrices;
+            Eigen::Matrix<float, Eigen::Dynamic, 7, Eigen::RowMajor> _poses;
+        };
+    } // namespace objects
+} // namespace graphics_lib
+
+#endif // GRAPHICSLIB_POSE_BATCH_HPP
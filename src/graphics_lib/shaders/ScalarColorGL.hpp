@@ -0,0 +1,140 @@
+/*
+    This file is part of graphics-lib.
+
+    Copyright (c) 2020, 2021, 2022 Bernardo Fichera <bernardo.fichera@gmail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef GRAPHICSLIB_SCALAR_COLOR_GL_HPP
+#define GRAPHICSLIB_SCALAR_COLOR_GL_HPP
+
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/GL/AbstractShaderProgram.h>
+#include <Magnum/GL/Attribute.h>
+#include <Magnum/GL/Shader.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/GL/Version.h>
+#include <Magnum/Math/Matrix3.h>
+#include <Magnum/Math/Matrix4.h>
+
+namespace graphics_lib {
+    namespace shaders {
+        // Colormap shader: one float scalar per vertex, mapped to color on the GPU by sampling a Nx1 colormap texture
+        template <size_t N = 3>
+        class ScalarColorGL : public GL::AbstractShaderProgram {
+        public:
+            typedef GL::Attribute<0, std::conditional_t<N == 3, Vector3, Vector2>> Position;
+            typedef GL::Attribute<1, Float> Scalar;
+
+            explicit ScalarColorGL()
+            {
+                GL::Shader vert{GL::Version::GL330, GL::Shader::Type::Vertex};
+                GL::Shader frag{GL::Version::GL330, GL::Shader::Type::Fragment};
+
+                if constexpr (N == 2)
+                    vert.addSource("#define TWO_DIMENSIONS\n");
+
+                vert.addSource(vertexSource());
+                frag.addSource(fragmentSource());
+
+                CORRADE_INTERNAL_ASSERT_OUTPUT(vert.compile() && frag.compile());
+
+                attachShaders({vert, frag});
+
+                bindAttributeLocation(Position::Location, "position");
+                bindAttributeLocation(Scalar::Location, "scalar");
+
+                CORRADE_INTERNAL_ASSERT_OUTPUT(link());
+
+                _transformationProjectionMatrixUniform = uniformLocation("transformationProjectionMatrix");
+                _rangeUniform = uniformLocation("range");
+
+                setUniform(uniformLocation("colormapTexture"), ColormapTextureUnit);
+                setRange(-1.0f, 1.0f);
+            }
+
+            ScalarColorGL& setTransformationProjectionMatrix(const std::conditional_t<N == 3, Matrix4, Matrix3>& matrix)
+            {
+                setUniform(_transformationProjectionMatrixUniform, matrix);
+                return *this;
+            }
+
+            // Scalar values mapped to the first and the last colormap entry
+            ScalarColorGL& setRange(const Float& min, const Float& max)
+            {
+                setUniform(_rangeUniform, Vector2{min, max});
+                return *this;
+            }
+
+            ScalarColorGL& bindColormapTexture(GL::Texture2D& texture)
+            {
+                texture.bind(ColormapTextureUnit);
+                return *this;
+            }
+
+        private:
+            enum : Int { ColormapTextureUnit = 0 };
+
+            static const char* vertexSource()
+            {
+                return R"GLSL(
+#ifdef TWO_DIMENSIONS
+uniform highp mat3 transformationProjectionMatrix;
+in highp vec2 position;
+#else
+uniform highp mat4 transformationProjectionMatrix;
+in highp vec4 position;
+#endif
+uniform highp vec2 range;
+in highp float scalar;
+out mediump float interpolatedValue;
+
+void main() {
+    interpolatedValue = (scalar - range.x)/(range.y - range.x);
+#ifdef TWO_DIMENSIONS
+    gl_Position.xywz = vec4(transformationProjectionMatrix*vec3(position, 1.0), 0.0);
+#else
+    gl_Position = transformationProjectionMatrix*position;
+#endif
+}
+)GLSL";
+            }
+
+            static const char* fragmentSource()
+            {
+                return R"GLSL(
+uniform lowp sampler2D colormapTexture;
+in mediump float interpolatedValue;
+out lowp vec4 fragmentColor;
+
+void main() {
+    /* Clamp out-of-range values and hit the texel centers of the first/last entry */
+    highp float size = float(textureSize(colormapTexture, 0).x);
+    fragmentColor = texture(colormapTexture, vec2((clamp(interpolatedValue, 0.0, 1.0)*(size - 1.0) + 0.5)/size, 0.5));
+}
+)GLSL";
+            }
+
+            Int _transformationProjectionMatrixUniform, _rangeUniform;
+        };
+    } // namespace shaders
+} // namespace graphics_lib
+
+#endif // GRAPHICSLIB_SCALAR_COLOR_GL_HPP
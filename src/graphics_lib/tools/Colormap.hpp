@@ -0,0 +1,124 @@
+/*
+    This file is part of graphics-lib.
+
+    Copyright (c) 2020, 2021, 2022 Bernardo Fichera <bernardo.fichera@gmail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef GRAPHICSLIB_TOOLS_COLORMAP_HPP
+#define GRAPHICSLIB_TOOLS_COLORMAP_HPP
+
+#include <algorithm>
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Utility/Debug.h>
+#include <Eigen/Core>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Packing.h>
+
+namespace graphics_lib {
+    namespace tools {
+        // Colormap lookup table, converted once to linear RGB (shading) and packed 8-bit sRGB (textures, vertex colors)
+        class Colormap {
+        public:
+            Colormap() = default;
+
+            // From 8-bit sRGB entries (e.g. DebugTools::ColorMap)
+            explicit Colormap(Containers::ArrayView<const Vector3ub> srgb)
+                : _linear{Containers::NoInit, srgb.size()}, _srgb{Containers::NoInit, srgb.size()}
+            {
+                for (size_t i = 0; i < srgb.size(); i++) {
+                    _linear[i] = Color3::fromSrgb(srgb[i]);
+                    _srgb[i] = Color4ub{srgb[i], 255};
+                }
+            }
+
+            // From sRGB entries in [0, 1] (one row per entry)
+            explicit Colormap(const Eigen::Ref<const Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor>>& srgb)
+                : _linear{Containers::NoInit, size_t(srgb.rows())}, _srgb{Containers::NoInit, size_t(srgb.rows())}
+            {
+                for (size_t i = 0; i < _linear.size(); i++) {
+                    const Vector3 entry = Math::clamp(Vector3(srgb(i, 0), srgb(i, 1), srgb(i, 2)), 0.0f, 1.0f);
+                    _linear[i] = Color3::fromSrgb(entry);
+                    _srgb[i] = Color4ub{Math::pack<Vector3ub>(entry), 255};
+                }
+            }
+
+            size_t size() const { return _linear.size(); }
+
+            Containers::ArrayView<const Color3> linear() const { return _linear; }
+
+            Containers::ArrayView<const Color4ub> srgb() const { return _srgb; }
+
+            // Linear RGB color of every value (one row per value)
+            void map(const Eigen::Ref<const Eigen::VectorXd>& values, const double& min, const double& max, Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor>& colors) const
+            {
+                colors.resize(values.size(), 3);
+                Color3* out = reinterpret_cast<Color3*>(colors.data());
+
+                lookup(values, min, max, [&](const size_t& i, const int& entry) { out[i] = _linear[entry]; });
+            }
+
+            // Packed 8-bit sRGB color of every value (same layout as PixelFormat::RGBA8Srgb)
+            void map(const Eigen::Ref<const Eigen::VectorXd>& values, const double& min, const double& max, Containers::ArrayView<Color4ub> colors) const
+            {
+                if (colors.size() < size_t(values.size())) {
+                    Warning{} << "Colormap: output too small," << colors.size() << "colors for" << values.size() << "values";
+                    return;
+                }
+
+                lookup(values, min, max, [&](const size_t& i, const int& entry) { colors[i] = _srgb[entry]; });
+            }
+
+        protected:
+            // Values processed per block (indices kept on the stack)
+            static constexpr Eigen::Index BlockSize = 4096;
+
+            // Table entry of every value, values outside [min, max] are clamped to the first/last entry (NaN to the first one)
+            template <typename Callback>
+            void lookup(const Eigen::Ref<const Eigen::VectorXd>& values, const double& min, const double& max, Callback&& callback) const
+            {
+                if (_linear.isEmpty())
+                    return;
+
+                const double last = double(_linear.size() - 1), scale = max > min ? _linear.size() / (max - min) : 0.0;
+
+                Eigen::Array<double, Eigen::Dynamic, 1, 0, BlockSize, 1> scaled;
+                Eigen::Array<int, Eigen::Dynamic, 1, 0, BlockSize, 1> entries;
+
+                for (Eigen::Index offset = 0; offset < values.size(); offset += BlockSize) {
+                    const Eigen::Index count = std::min(BlockSize, values.size() - offset);
+
+                    // Vectorized scaling, clamping and truncation (NaN passes through max/min and cannot be cast to int)
+                    scaled = (values.segment(offset, count).array() - min) * scale;
+                    entries = (scaled == scaled).select(scaled, 0.0).max(0.0).min(last).cast<int>();
+
+                    for (Eigen::Index i = 0; i < count; i++)
+                        callback(size_t(offset + i), entries[i]);
+                }
+            }
+
+            Containers::Array<Color3> _linear;
+            Containers::Array<Color4ub> _srgb;
+        };
+    } // namespace tools
+} // namespace graphics_lib
+
+#endif // GRAPHICSLIB_TOOLS_COLORMAP_HPP
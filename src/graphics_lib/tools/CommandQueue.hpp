@@ -0,0 +1,131 @@
+/*
+    This file is part of graphics-lib.
+
+    Copyright (c) 2020, 2021, 2022 Bernardo Fichera <bernardo.fichera@gmail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef GRAPHICSLIB_TOOLS_COMMAND_QUEUE_HPP
+#define GRAPHICSLIB_TOOLS_COMMAND_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <utility>
+
+#include <Corrade/Containers/Array.h>
+
+namespace graphics_lib {
+    namespace tools {
+        // Bounded lock-free multi-producer single-consumer ring (slots preallocated, pushing never allocates)
+        // Producers claim a slot with a single compare-exchange, the consumer takes the pending commands in push order
+        template <typename Command>
+        class CommandQueue {
+        public:
+            // Capacity rounded up to a power of two
+            explicit CommandQueue(const std::size_t& capacity = 4096) : _slots{roundUp(capacity)}, _mask{_slots.size() - 1}
+            {
+                for (std::size_t i = 0; i < _slots.size(); ++i)
+                    _slots[i].sequence.store(i, std::memory_order_relaxed);
+            }
+
+            CommandQueue(const CommandQueue&) = delete;
+            CommandQueue& operator=(const CommandQueue&) = delete;
+
+            // Enqueue a command (any thread), waits for the consumer while the ring is full
+            void push(Command command)
+            {
+                std::size_t position = _tail.load(std::memory_order_relaxed);
+
+                for (;;) {
+                    Slot& slot = _slots[position & _mask];
+                    const std::ptrdiff_t difference = std::ptrdiff_t(slot.sequence.load(std::memory_order_acquire)) - std::ptrdiff_t(position);
+
+                    // Free slot, claim it
+                    if (!difference) {
+                        if (_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                            slot.command = std::move(command);
+                            slot.sequence.store(position + 1, std::memory_order_release);
+                            return;
+                        }
+                    }
+                    // Full (the oldest command is not consumed yet)
+                    else if (difference < 0) {
+                        std::this_thread::yield();
+                        position = _tail.load(std::memory_order_relaxed);
+                    }
+                    // Claimed by another producer
+                    else
+                        position = _tail.load(std::memory_order_relaxed);
+                }
+            }
+
+            // Nothing pending (consumer thread only, approximate when producers are running)
+            bool empty() const { return _head == _tail.load(std::memory_order_relaxed); }
+
+            // Call "consume" on every pending command in push order (consumer thread only)
+            // Commands pushed meanwhile (e.g. by the consumed calls) wait for the next drain
+            template <typename Consumer>
+            void drain(Consumer&& consume)
+            {
+                const std::size_t end = _tail.load(std::memory_order_acquire);
+
+                while (_head != end) {
+                    Slot& slot = _slots[_head & _mask];
+
+                    // Claimed but still being written, next drain
+                    if (slot.sequence.load(std::memory_order_acquire) != _head + 1)
+                        break;
+
+                    // Slot released before consuming (the command may push again)
+                    Command command = std::move(slot.command);
+                    slot.sequence.store(_head + _mask + 1, std::memory_order_release);
+                    ++_head;
+
+                    consume(command);
+                }
+            }
+
+        protected:
+            struct Slot {
+                std::atomic<std::size_t> sequence;
+                Command command;
+            };
+
+            static std::size_t roundUp(const std::size_t& capacity)
+            {
+                std::size_t size = 2;
+                while (size < capacity)
+                    size *= 2;
+                return size;
+            }
+
+            // Slots (the sequence tells whether a slot is free, written or consumed for the current lap)
+            Containers::Array<Slot> _slots;
+            std::size_t _mask;
+
+            // Next slot to claim (producers) and next slot to consume (consumer), on separate cache lines
+            alignas(64) std::atomic<std::size_t> _tail{0};
+            alignas(64) std::size_t _head = 0;
+        };
+    } // namespace tools
+} // namespace graphics_lib
+
+#endif // GRAPHICSLIB_TOOLS_COMMAND_QUEUE_HPP
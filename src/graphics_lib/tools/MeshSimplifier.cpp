@@ -0,0 +1,162 @@
+/*
+    This file is part of graphics-lib.
+
+    Copyright (c) 2020, 2021, 2022 Bernardo Fichera <bernardo.fichera@gmail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "graphics_lib/tools/MeshSimplifier.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/Debug.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/MeshTools/RemoveDuplicates.h>
+#include <Magnum/Trade/AbstractSceneConverter.h>
+#include <Magnum/Trade/MeshData.h>
+
+namespace graphics_lib {
+    namespace tools {
+        MeshSimplifier::MeshSimplifier(const size_t& levels, const Float& ratio) : _levels(levels), _ratio(ratio) {}
+
+        Containers::Array<Containers::Array<MeshLevel>> MeshSimplifier::simplify(Containers::ArrayView<const Containers::Pair<Containers::ArrayView<const Vector3>, Containers::ArrayView<const UnsignedInt>>> meshes) const
+        {
+            Containers::Array<Containers::Array<MeshLevel>> levels{meshes.size()};
+
+            if (!_levels || meshes.isEmpty())
+                return levels;
+
+            // Plugin loaded and instantiated here (the manager is not thread-safe), one converter per worker
+            PluginManager::Manager<Trade::AbstractSceneConverter> manager;
+            if (!(manager.load("MeshOptimizerSceneConverter") & PluginManager::LoadState::Loaded)) {
+                Warning{} << "MeshOptimizerSceneConverter not available, meshes are not simplified";
+                return levels;
+            }
+
+            // Fixed pool of workers taking the meshes in order (scenes can have thousands of parts)
+            const size_t count = std::min<size_t>(meshes.size(), std::max(std::thread::hardware_concurrency(), 1u));
+
+            std::vector<Containers::Pointer<Trade::AbstractSceneConverter>> converters;
+            for (size_t i = 0; i < count; ++i) {
+                converters.push_back(manager.instantiate("MeshOptimizerSceneConverter"));
+
+                Trade::AbstractSceneConverter& converter = *converters.back();
+                converter.configuration().setValue("simplify", true);
+                converter.configuration().setValue("simplifySloppy", false);
+                // Vertex order has to be kept, the levels index the vertices of the full mesh
+                converter.configuration().setValue("optimizeVertexFetch", false);
+                converter.configuration().setValue("optimizeOverdraw", false);
+            }
+
+            std::atomic<size_t> next{0};
+            auto work = [&](Trade::AbstractSceneConverter& converter) {
+                for (size_t i; (i = next++) < meshes.size();)
+                    levels[i] = simplify(converter, meshes[i].first(), meshes[i].second());
+            };
+
+            // The calling thread is one of the workers
+            std::vector<std::thread> workers;
+            for (size_t i = 1; i < count; ++i)
+                workers.emplace_back(work, std::ref(*converters[i]));
+            work(*converters[0]);
+
+            for (std::thread& worker : workers)
+                worker.join();
+
+            return levels;
+        }
+
+        Containers::Array<MeshLevel> MeshSimplifier::simplify(Trade::AbstractSceneConverter& converter, Containers::ArrayView<const Vector3> positions, Containers::ArrayView<const UnsignedInt> indices) const
+        {
+            Containers::Array<MeshLevel> levels;
+
+            if (positions.isEmpty() || indices.size() < 3 || indices.size() % 3)
+                return levels;
+
+            // Weld vertices sharing the same position (split normals/uvs and triangle soups would not collapse otherwise)
+            Containers::Array<Vector3> unique{Containers::NoInit, positions.size()};
+            for (size_t i = 0; i < positions.size(); ++i)
+                unique[i] = positions[i];
+
+            const Containers::Pair<Containers::Array<UnsignedInt>, std::size_t> welded = MeshTools::removeDuplicatesInPlace(Containers::arrayCast<2, char>(Containers::stridedArrayView(unique)));
+            arrayResize(unique, welded.second());
+
+            // Any original vertex at the welded position is used to draw the simplified triangles
+            Containers::Array<UnsignedInt> representative{Containers::NoInit, welded.second()};
+            for (size_t i = welded.first().size(); i-- > 0;)
+                representative[welded.first()[i]] = UnsignedInt(i);
+
+            Containers::Array<UnsignedInt> current{Containers::NoInit, indices.size()};
+            for (size_t i = 0; i < indices.size(); ++i)
+                current[i] = welded.first()[indices[i]];
+
+            // Errors are relative to the mesh extent
+            Vector3 min = unique[0], max = unique[0];
+            for (const Vector3& position : unique) {
+                min = Math::min(min, position);
+                max = Math::max(max, position);
+            }
+            const Float extent = (max - min).max();
+
+            Float target = BaseError, error = 0.0f;
+
+            for (size_t level = 0; level < _levels; ++level) {
+                Containers::Array<Trade::MeshAttributeData> attributes{Containers::InPlaceInit, {Trade::MeshAttributeData{Trade::MeshAttribute::Position, Containers::arrayView(unique)}}};
+                const Trade::MeshData mesh{MeshPrimitive::Triangles, Trade::DataFlags{}, current, Trade::MeshIndexData{current}, Trade::DataFlags{}, unique, std::move(attributes)};
+
+                converter.configuration().setValue("simplifyTargetIndexCountThreshold", _ratio);
+                converter.configuration().setValue("simplifyTargetError", target);
+
+                Containers::Optional<Trade::MeshData> simplified = converter.convert(mesh);
+                if (!simplified || !simplified->isIndexed() || simplified->vertexCount() != unique.size())
+                    break;
+
+                Containers::Array<UnsignedInt> next = simplified->indicesAsArray();
+
+                // Stop when the error bound prevents any significant reduction
+                if (next.isEmpty() || next.size() > 0.9f * current.size())
+                    break;
+
+                // Each level is simplified from the previous one, errors add up
+                error += target * extent;
+
+                MeshLevel result{Containers::Array<UnsignedInt>{Containers::NoInit, next.size()}, error};
+                for (size_t i = 0; i < next.size(); ++i)
+                    result.indices[i] = representative[next[i]];
+                arrayAppend(levels, std::move(result));
+
+                current = std::move(next);
+                target *= 4.0f;
+            }
+
+            return levels;
+        }
+    } // namespace tools
+} // namespace graphics_lib
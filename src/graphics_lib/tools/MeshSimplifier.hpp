@@ -0,0 +1,65 @@
+/*
+    This file is part of graphics-lib.
+
+    Copyright (c) 2020, 2021, 2022 Bernardo Fichera <bernardo.fichera@gmail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef GRAPHICSLIB_TOOLS_MESH_SIMPLIFIER_HPP
+#define GRAPHICSLIB_TOOLS_MESH_SIMPLIFIER_HPP
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Pair.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Vector3.h>
+#include <Magnum/Trade/Trade.h>
+
+namespace graphics_lib {
+    namespace tools {
+        // Simplified triangle list (indices of the original vertices) and bound of its geometric error (mesh units)
+        struct MeshLevel {
+            Containers::Array<UnsignedInt> indices;
+            Float error;
+        };
+
+        // Successive quadric-error simplifications of triangle meshes (MeshOptimizerSceneConverter plugin)
+        // Vertices are never modified, so the levels share the vertex buffer (and all the attributes) of the full mesh
+        class MeshSimplifier {
+        public:
+            // Up to "levels" levels, each keeping about "ratio" of the triangles of the previous one
+            explicit MeshSimplifier(const size_t& levels = 4, const Float& ratio = 0.5f);
+
+            // Levels of each mesh [positions, triangle indices], computed by a pool of hardware_concurrency() workers
+            // Meshes that cannot be simplified (or a missing plugin) get no levels
+            Containers::Array<Containers::Array<MeshLevel>> simplify(Containers::ArrayView<const Containers::Pair<Containers::ArrayView<const Vector3>, Containers::ArrayView<const UnsignedInt>>> meshes) const;
+
+        protected:
+            // Relative error allowed to the first level (multiplied by 4 at every level)
+            static constexpr Float BaseError = 1.0e-3f;
+
+            Containers::Array<MeshLevel> simplify(Trade::AbstractSceneConverter& converter, Containers::ArrayView<const Vector3> positions, Containers::ArrayView<const UnsignedInt> indices) const;
+
+            size_t _levels;
+            Float _ratio;
+        };
+    } // namespace tools
+} // namespace graphics_lib
+
+#endif // GRAPHICSLIB_TOOLS_MESH_SIMPLIFIER_HPP
@@ -0,0 +1,205 @@
+/*
+    This file is part of graphics-lib.
+
+    Copyright (c) 2020, 2021, 2022 Bernardo Fichera <bernardo.fichera@gmail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "graphics_lib/tools/Profiler.hpp"
+
+#include <fstream>
+
+#include <Corrade/Utility/Debug.h>
+
+namespace graphics_lib {
+    namespace tools {
+        Profiler::Section::Section(Profiler* profiler, const char* name, const bool& gpu)
+            : _profiler(profiler), _event(0), _query(NoQuery)
+        {
+            if (_profiler)
+                _event = _profiler->open(name, gpu, _query);
+        }
+
+        Profiler::Section::Section(Section&& other) noexcept
+            : _profiler(other._profiler), _event(other._event), _query(other._query)
+        {
+            other._profiler = nullptr;
+        }
+
+        Profiler::Section::~Section()
+        {
+            if (_profiler)
+                _profiler->close(_event, _query);
+        }
+
+        Profiler::Profiler(const size_t& history)
+            : _enabled(false), _history(history ? history : 1), _frame(0), _inFrame(false), _frameEvent(0), _firstEvent(0), _used{}, _gpuOrigin(0) {}
+
+        Profiler& Profiler::setEnabled(const bool& enable)
+        {
+            if (enable && !_enabled) {
+                clear();
+
+                // Common origin of the CPU and GPU timelines (single synchronous query)
+                GL::TimeQuery origin{GL::TimeQuery::Target::Timestamp};
+                origin.timestamp();
+                _gpuOrigin = origin.result<Long>();
+                _origin = Clock::now();
+            }
+
+            _enabled = enable;
+
+            return *this;
+        }
+
+        void Profiler::beginFrame()
+        {
+            if (!_enabled)
+                return;
+
+            ++_frame;
+            _inFrame = true;
+
+            // Queries of this slot were issued Latency frames ago
+            collect(_frame % Latency);
+
+            // Drop the frames out of the history
+            while (!_events.empty() && _events.front().frame + _history <= _frame) {
+                _events.pop_front();
+                ++_firstEvent;
+            }
+
+            _frameEvent = _firstEvent + _events.size();
+            _events.push_back(Event{"frame", _frame, now(), 0});
+        }
+
+        void Profiler::endFrame()
+        {
+            if (!_enabled || !_inFrame)
+                return;
+
+            _inFrame = false;
+
+            size_t index;
+            if (find(_frameEvent, index))
+                _events[index].duration = now() - _events[index].start;
+        }
+
+        bool Profiler::save(const std::string& file) const
+        {
+            std::ofstream out(file);
+
+            if (!out) {
+                Error{} << "Cannot write" << file.c_str();
+                return false;
+            }
+
+            out << "{\"traceEvents\": [\n";
+            out << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": 0, \"args\": {\"name\": \"CPU\"}},\n";
+            out << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": 1, \"args\": {\"name\": \"GPU\"}}";
+
+            for (const Event& event : _events) {
+                out << ",\n{\"name\": \"" << event.name << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": 0, \"ts\": " << event.start << ", \"dur\": " << event.duration
+                    << ", \"args\": {\"frame\": " << event.frame << "}}";
+
+                if (event.gpuDuration >= 0)
+                    out << ",\n{\"name\": \"" << event.name << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": 1, \"ts\": " << event.gpuStart << ", \"dur\": " << event.gpuDuration
+                        << ", \"args\": {\"frame\": " << event.frame << "}}";
+            }
+
+            out << "\n]}" << std::endl;
+
+            return bool(out);
+        }
+
+        Profiler& Profiler::clear()
+        {
+            _firstEvent += _events.size();
+            _events.clear();
+
+            for (size_t i = 0; i < Latency; ++i)
+                _used[i] = 0;
+
+            return *this;
+        }
+
+        size_t Profiler::open(const char* name, const bool& gpu, size_t& query)
+        {
+            const size_t id = _firstEvent + _events.size();
+            _events.push_back(Event{name, _frame, now(), 0});
+
+            query = NoQuery;
+            if (gpu) {
+                std::vector<Queries>& pool = _queries[_frame % Latency];
+                size_t& used = _used[_frame % Latency];
+
+                if (used == pool.size())
+                    pool.emplace_back();
+
+                pool[used].event = id;
+                pool[used].begin.timestamp();
+                query = used++;
+            }
+
+            return id;
+        }
+
+        void Profiler::close(const size_t& event, const size_t& query)
+        {
+            size_t index;
+            if (!find(event, index))
+                return;
+
+            _events[index].duration = now() - _events[index].start;
+
+            // Queries live in the slot of the frame the section started in
+            const size_t slot = _events[index].frame % Latency;
+            if (query != NoQuery && query < _used[slot] && _queries[slot][query].event == event)
+                _queries[slot][query].end.timestamp();
+        }
+
+        void Profiler::collect(const size_t& slot)
+        {
+            for (size_t i = 0; i < _used[slot]; ++i) {
+                Queries& queries = _queries[slot][i];
+
+                // Blocks only when the GPU is more than Latency frames behind
+                const Long begin = queries.begin.result<Long>(), end = queries.end.result<Long>();
+
+                size_t index;
+                if (find(queries.event, index)) {
+                    _events[index].gpuStart = (begin - _gpuOrigin) * 1e-3;
+                    _events[index].gpuDuration = (end - begin) * 1e-3;
+                }
+            }
+
+            _used[slot] = 0;
+        }
+
+        bool Profiler::find(const size_t& id, size_t& index) const
+        {
+            if (id < _firstEvent || id >= _firstEvent + _events.size())
+                return false;
+
+            index = id - _firstEvent;
+            return true;
+        }
+    } // namespace tools
+} // namespace graphics_lib
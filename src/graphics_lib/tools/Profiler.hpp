@@ -0,0 +1,134 @@
+/*
+    This file is part of graphics-lib.
+
+    Copyright (c) 2020, 2021, 2022 Bernardo Fichera <bernardo.fichera@gmail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef GRAPHICSLIB_TOOLS_PROFILER_HPP
+#define GRAPHICSLIB_TOOLS_PROFILER_HPP
+
+#include <chrono>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <Magnum/GL/TimeQuery.h>
+#include <Magnum/Magnum.h>
+
+namespace graphics_lib {
+    namespace tools {
+        // CPU timers and GPU timestamp queries per section, rolling history of the last frames and Chrome trace export
+        // Disabled by default: sections and frames then cost a single flag check
+        class Profiler {
+        public:
+            // Timed section (CPU time of the scope and, when requested, GPU time of the commands issued inside it)
+            struct Event {
+                const char* name; // static string
+                size_t frame;
+                Double start, duration; // CPU, microseconds since the profiler was enabled
+                Double gpuStart = -1, gpuDuration = -1; // GPU, negative until (or unless) measured
+            };
+
+            // Scope guard returned by section()
+            class Section {
+            public:
+                Section(Profiler* profiler, const char* name, const bool& gpu);
+                Section(Section&& other) noexcept;
+                Section(const Section&) = delete;
+                Section& operator=(const Section&) = delete;
+                Section& operator=(Section&&) = delete;
+                ~Section();
+
+            private:
+                Profiler* _profiler;
+                size_t _event, _query;
+            };
+
+            // Keep the events of the last "history" frames
+            explicit Profiler(const size_t& history = 300);
+
+            // Enable/disable instrumentation (GPU queries are created on first use, a GL context has to be current)
+            Profiler& setEnabled(const bool& enable);
+
+            bool isEnabled() const { return _enabled; }
+
+            // Time the current scope ("name" has to outlive the profiler, e.g. a string literal)
+            Section section(const char* name, const bool& gpu = false) { return Section{_enabled ? this : nullptr, name, gpu}; }
+
+            // Frame delimiters (GPU results of older frames are collected here)
+            void beginFrame();
+            void endFrame();
+
+            // Events of the frames in the history (GPU times of the last few frames may still be missing)
+            const std::deque<Event>& events() const { return _events; }
+
+            // Save the history as Chrome trace (chrome://tracing, Perfetto), CPU and GPU on separate tracks
+            bool save(const std::string& file) const;
+
+            // Drop the history
+            Profiler& clear();
+
+        protected:
+            using Clock = std::chrono::steady_clock;
+
+            // GPU results are read this many frames later (no stall unless the GPU is further behind)
+            static constexpr size_t Latency = 3;
+
+            // Pair of timestamp queries around a section
+            struct Queries {
+                GL::TimeQuery begin{GL::TimeQuery::Target::Timestamp}, end{GL::TimeQuery::Target::Timestamp};
+                size_t event;
+            };
+
+            Double now() const { return std::chrono::duration<Double, std::micro>(Clock::now() - _origin).count(); }
+
+            // Start/stop a section ("query" is the index of its GPU queries in the current slot, NoQuery if none)
+            static constexpr size_t NoQuery = ~size_t{};
+            size_t open(const char* name, const bool& gpu, size_t& query);
+            void close(const size_t& event, const size_t& query);
+
+            // Read the queries of a frame slot back into their events
+            void collect(const size_t& slot);
+
+            // Index of an event id in the history (false if already dropped)
+            bool find(const size_t& id, size_t& index) const;
+
+            bool _enabled;
+            size_t _history, _frame;
+            bool _inFrame;
+            size_t _frameEvent;
+
+            // Events (ids are consecutive, the first one is _firstEvent)
+            std::deque<Event> _events;
+            size_t _firstEvent;
+
+            // Query pool per in-flight frame (used count per slot)
+            std::vector<Queries> _queries[Latency];
+            size_t _used[Latency];
+
+            // CPU/GPU clock origins
+            Clock::time_point _origin;
+            Long _gpuOrigin;
+        };
+    } // namespace tools
+} // namespace graphics_lib
+
+#endif // GRAPHICSLIB_TOOLS_PROFILER_HPP
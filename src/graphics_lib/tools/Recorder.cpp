@@ -0,0 +1,222 @@
+/*
+    This file is part of graphics-lib.
+
+    Copyright (c) 2020, 2021, 2022 Bernardo Fichera <bernardo.fichera@gmail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "graphics_lib/tools/Recorder.hpp"
+
+#include <cstring>
+#include <limits>
+
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/Containers/StringStl.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/PixelFormat.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Trade/AbstractImageConverter.h>
+
+namespace graphics_lib {
+    namespace tools {
+        namespace {
+            // Marks an empty slot of the ring
+            constexpr size_t NoFrame = std::numeric_limits<size_t>::max();
+
+            // Split a pattern around its only frame number conversion (%d, %Nd or %0Nd, "%%" is a literal percent sign)
+            bool splitPattern(const std::string& pattern, std::string& prefix, std::string& suffix, size_t& width, char& fill)
+            {
+                bool found = false;
+                std::string* part = &prefix;
+
+                for (size_t i = 0; i < pattern.size(); ++i) {
+                    if (pattern[i] != '%') {
+                        *part += pattern[i];
+                        continue;
+                    }
+
+                    if (i + 1 < pattern.size() && pattern[i + 1] == '%') {
+                        *part += '%';
+                        ++i;
+                        continue;
+                    }
+
+                    if (found)
+                        return false;
+
+                    size_t j = i + 1;
+                    fill = (j < pattern.size() && pattern[j] == '0') ? '0' : ' ';
+                    width = 0;
+                    for (; j < pattern.size() && pattern[j] >= '0' && pattern[j] <= '9'; ++j)
+                        width = 10 * width + (pattern[j] - '0');
+
+                    if (j == pattern.size() || pattern[j] != 'd' || width > 32)
+                        return false;
+
+                    found = true;
+                    part = &suffix;
+                    i = j;
+                }
+
+                return found;
+            }
+        } // namespace
+
+        Recorder::Recorder(const std::string& output, const bool& pipe, const size_t& buffers, const size_t& queued, const bool& drop)
+            : _output(output), _pipe(nullptr), _fill(' '), _captured(0), _queued(queued ? queued : 1), _dropped(0), _drop(drop), _stop(false)
+        {
+            if (pipe && !(_pipe = popen(output.c_str(), "w")))
+                Error{} << "Cannot start" << output.c_str();
+
+            // The pattern is never used as a format string
+            size_t width = 0;
+            if (!pipe) {
+                if (splitPattern(output, _prefix, _suffix, width, _fill))
+                    _width = width;
+                else
+                    Error{} << "Invalid pattern" << output.c_str() << "(expected a single %d or %0Nd), frames are not written";
+            }
+
+            // At least two buffers, otherwise the readback is mapped right after being issued
+            const size_t count = buffers < 2 ? 2 : buffers;
+            _ring = Containers::Array<GL::BufferImage2D>{Containers::NoInit, count};
+            for (GL::BufferImage2D& image : _ring)
+                new (&image) GL::BufferImage2D{GL::PixelFormat::RGBA, GL::PixelType::UnsignedByte};
+            _pending = Containers::Array<size_t>{Containers::DirectInit, count, NoFrame};
+
+            _writer = std::thread(&Recorder::write, this);
+        }
+
+        Recorder::~Recorder()
+        {
+            // Collect the readbacks still in flight (oldest first)
+            for (size_t i = 0; i < _ring.size(); ++i) {
+                const size_t slot = (_captured + i) % _ring.size();
+                if (_pending[slot] != NoFrame)
+                    collect(_ring[slot], _pending[slot]);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stop = true;
+            }
+            _condition.notify_one();
+            _writer.join();
+
+            if (_pipe)
+                pclose(_pipe);
+        }
+
+        Recorder& Recorder::capture(GL::AbstractFramebuffer& framebuffer)
+        {
+            const size_t slot = _captured % _ring.size();
+
+            // This buffer was filled "size" frames ago, by now the transfer is done and mapping does not stall
+            if (_pending[slot] != NoFrame)
+                collect(_ring[slot], _pending[slot]);
+
+            // Asynchronous transfer into the pixel buffer (returns immediately)
+            framebuffer.read(framebuffer.viewport(), _ring[slot], GL::BufferUsage::StreamRead);
+            _pending[slot] = _captured++;
+
+            return *this;
+        }
+
+        void Recorder::collect(GL::BufferImage2D& image, const size_t& index)
+        {
+            Frame frame{index, image.size(), Containers::Array<char>{Containers::NoInit, image.dataSize()}};
+
+            Containers::ArrayView<const char> data = image.buffer().mapRead(0, image.dataSize());
+            if (data)
+                std::memcpy(frame.pixels.data(), data.data(), data.size());
+            image.buffer().unmap();
+
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+
+                // Bounded queue: wait for the writer or drop the frame
+                if (_queue.size() >= _queued) {
+                    if (_drop) {
+                        ++_dropped;
+                        return;
+                    }
+
+                    _space.wait(lock, [this] { return _queue.size() < _queued; });
+                }
+
+                _queue.push_back(std::move(frame));
+            }
+            _condition.notify_one();
+        }
+
+        std::string Recorder::fileName(const size_t& index) const
+        {
+            const std::string number = std::to_string(index);
+            return _prefix + (number.size() < *_width ? std::string(*_width - number.size(), _fill) : std::string{}) + number + _suffix;
+        }
+
+        void Recorder::write()
+        {
+            // Converter used only by this thread
+            PluginManager::Manager<Trade::AbstractImageConverter> manager;
+            Containers::Pointer<Trade::AbstractImageConverter> converter;
+            if (!_pipe)
+                converter = manager.loadAndInstantiate("AnyImageConverter");
+
+            Containers::Array<char> flipped;
+
+            while (true) {
+                Frame frame;
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _condition.wait(lock, [this] { return _stop || !_queue.empty(); });
+                    if (_queue.empty())
+                        return;
+
+                    frame = std::move(_queue.front());
+                    _queue.pop_front();
+                }
+                _space.notify_one();
+
+                // Tightly packed RGBA rows (default pack alignment of 4)
+                const ImageView2D image{PixelFormat::RGBA8Unorm, frame.size, frame.pixels};
+
+                if (_pipe) {
+                    // OpenGL rows go bottom to top, encoders expect top to bottom
+                    const size_t stride = 4 * frame.size.x();
+                    if (flipped.size() != frame.pixels.size())
+                        flipped = Containers::Array<char>{Containers::NoInit, frame.pixels.size()};
+                    for (Int y = 0; y < frame.size.y(); ++y)
+                        std::memcpy(flipped.data() + y * stride, frame.pixels.data() + (frame.size.y() - 1 - y) * stride, stride);
+
+                    if (std::fwrite(flipped.data(), 1, flipped.size(), _pipe) != flipped.size())
+                        Warning{} << "Cannot write frame" << frame.index;
+                }
+                else if (converter && _width) {
+                    if (!converter->convertToFile(image, fileName(frame.index)))
+                        Warning{} << "Cannot write frame" << frame.index;
+                }
+            }
+        }
+    } // namespace tools
+} // namespace graphics_lib
@@ -0,0 +1,104 @@
+/*
+    This file is part of graphics-lib.
+
+    Copyright (c) 2020, 2021, 2022 Bernardo Fichera <bernardo.fichera@gmail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef GRAPHICSLIB_TOOLS_RECORDER_HPP
+#define GRAPHICSLIB_TOOLS_RECORDER_HPP
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Magnum/GL/AbstractFramebuffer.h>
+#include <Magnum/GL/BufferImage.h>
+#include <Magnum/Magnum.h>
+
+namespace graphics_lib {
+    namespace tools {
+        class Recorder {
+        public:
+            // Record to an image sequence (pattern with a single %d or %0Nd frame number, e.g. "frames/frame_%05d.png", any format
+            // supported by AnyImageConverter) or pipe raw RGBA frames (top row first) to the standard input of a command
+            // (e.g. "ffmpeg -f rawvideo -pix_fmt rgba -s 800x600 -r 60 -i - video.mp4")
+            // At most "queued" frames wait for the writer: further captures wait for it, or are dropped if "drop" is set
+            explicit Recorder(const std::string& output, const bool& pipe = false, const size_t& buffers = 3, const size_t& queued = 8, const bool& drop = false);
+
+            // Flush the frames still in flight and wait for the writer
+            ~Recorder();
+
+            // Queue the asynchronous readback of the framebuffer (the data is collected "buffers" captures later)
+            Recorder& capture(GL::AbstractFramebuffer& framebuffer);
+
+            // Number of captured frames
+            size_t frames() const { return _captured; }
+
+            // Number of frames dropped because the writer could not keep up
+            size_t dropped() const { return _dropped; }
+
+        protected:
+            // Frame waiting to be written
+            struct Frame {
+                size_t index;
+                Vector2i size;
+                Containers::Array<char> pixels;
+            };
+
+            // Map a pixel buffer of the ring and hand its content to the writer
+            void collect(GL::BufferImage2D& image, const size_t& index);
+
+            // Writer thread loop
+            void write();
+
+            // File name of a frame of the image sequence
+            std::string fileName(const size_t& index) const;
+
+            // Output (image sequence pattern split around the frame number, valid only if "_width" is set)
+            std::string _output;
+            std::FILE* _pipe;
+            std::string _prefix, _suffix;
+            Containers::Optional<size_t> _width;
+            char _fill;
+
+            // Pixel buffers ring (and index of the frame stored in each of them)
+            Containers::Array<GL::BufferImage2D> _ring;
+            Containers::Array<size_t> _pending;
+            size_t _captured;
+
+            // Frames queue (bounded) & writer
+            std::deque<Frame> _queue;
+            size_t _queued, _dropped;
+            bool _drop;
+            std::mutex _mutex;
+            std::condition_variable _condition, _space;
+            bool _stop;
+            std::thread _writer;
+        };
+    } // namespace tools
+} // namespace graphics_lib
+
+#endif // GRAPHICSLIB_TOOLS_RECORDER_HPP
@@ -29,11 +29,18 @@
 
 namespace graphics_lib {
     namespace tools {
-        inline Eigen::VectorXi linearMap(const Eigen::VectorXd x, const double& min, const double& max, size_t n)
+        // Bin of every value among n equal bins of [min, max] (values outside the range go to the first/last bin, NaN to the first one)
+        inline Eigen::VectorXi linearMap(const Eigen::Ref<const Eigen::VectorXd>& x, const double& min, const double& max, size_t n)
         {
-            double q = abs(max - min) / n;
+            if (!n)
+                return Eigen::VectorXi::Zero(x.size());
 
-            return ((x.array() / q) + ceil(n / 2)).cast<int>();
+            const double scale = max > min ? n / (max - min) : 0.0;
+
+            // NaN passes through max/min and cannot be cast to int
+            const Eigen::ArrayXd scaled = (x.array() - min) * scale;
+
+            return (scaled == scaled).select(scaled, 0.0).max(0.0).min(double(n - 1)).cast<int>();
         }
     } // namespace tools
 } // namespace graphics_lib
@@ -0,0 +1,81 @@
+/*
+    This file is part of graphics-lib.
+
+    Copyright (c) 2020, 2021, 2022 Bernardo Fichera <bernardo.fichera@gmail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef GRAPHICSLIB_TOOLS_QUANTIZE_HPP
+#define GRAPHICSLIB_TOOLS_QUANTIZE_HPP
+
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Matrix4.h>
+#include <Magnum/Math/Packing.h>
+#include <Magnum/Math/Range.h>
+
+namespace graphics_lib {
+    namespace tools {
+        // Box the positions are quantized in (flat axes get a unit size)
+        inline Range3D quantizationRange(const Containers::StridedArrayView1D<const Vector3>& positions)
+        {
+            if (positions.isEmpty())
+                return Range3D{Vector3{0.0f}, Vector3{1.0f}};
+
+            Vector3 min = positions[0], max = positions[0];
+            for (const Vector3& position : positions) {
+                min = Math::min(min, position);
+                max = Math::max(max, position);
+            }
+
+            for (size_t i = 0; i < 3; ++i)
+                if (!(max[i] > min[i]))
+                    max[i] = min[i] + 1.0f;
+
+            return Range3D{min, max};
+        }
+
+        // Positions as 16-bit normalized coordinates inside the range (fourth component is padding, keeps vertices 4-byte aligned)
+        inline void quantizePositions(const Containers::StridedArrayView1D<const Vector3>& positions, const Range3D& range, const Containers::StridedArrayView1D<Vector4us>& quantized)
+        {
+            for (size_t i = 0; i < positions.size(); ++i)
+                quantized[i] = Vector4us{Math::pack<Vector3us>(Math::clamp((positions[i] - range.min()) / range.size(), 0.0f, 1.0f)), 0};
+        }
+
+        // Normals of positions quantized inside the range as 8-bit signed normalized values (fourth component is padding).
+        // The dequantization scaling D turns the normal matrix into M^-T D^-1, normals are scaled by D beforehand to cancel it
+        inline void quantizeNormals(const Containers::StridedArrayView1D<const Vector3>& normals, const Range3D& range, const Containers::StridedArrayView1D<Vector4b>& quantized)
+        {
+            for (size_t i = 0; i < normals.size(); ++i) {
+                const Vector3 normal = normals[i] * range.size();
+                const Float length = normal.length();
+                quantized[i] = Vector4b{Math::pack<Vector3b>(Math::clamp(length > 0.0f ? normal / length : normal, -1.0f, 1.0f)), 0};
+            }
+        }
+
+        // Transformation mapping quantized positions back into the range (to be applied before any other transformation)
+        inline Matrix4 dequantization(const Range3D& range)
+        {
+            return Matrix4::translation(range.min()) * Matrix4::scaling(range.size());
+        }
+    } // namespace tools
+} // namespace graphics_lib
+
+#endif // GRAPHICSLIB_TOOLS_QUANTIZE_HPP